@@ -54,7 +54,7 @@ add_library(leveldb STATIC EXCLUDE_FROM_ALL
 
 target_compile_definitions(leveldb
   PRIVATE
-    HAVE_SNAPPY=0
+    HAVE_SNAPPY=$<BOOL:${WITH_SNAPPY}>
     HAVE_CRC32C=1
     HAVE_FDATASYNC=$<BOOL:${HAVE_FDATASYNC}>
     HAVE_FULLFSYNC=$<BOOL:${HAVE_FULLFSYNC}>
@@ -98,6 +98,7 @@ target_link_libraries(leveldb PRIVATE
   core_interface
   nowarn_leveldb_interface
   crc32c
+  $<TARGET_NAME_IF_EXISTS:Snappy::Snappy>
 )
 
 set_target_properties(leveldb PROPERTIES
@@ -0,0 +1,29 @@
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or https://opensource.org/license/mit/.
+
+find_path(Snappy_INCLUDE_DIR
+  NAMES snappy.h
+)
+
+find_library(Snappy_LIBRARY
+  NAMES snappy
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Snappy
+  REQUIRED_VARS Snappy_LIBRARY Snappy_INCLUDE_DIR
+)
+
+if(Snappy_FOUND AND NOT TARGET Snappy::Snappy)
+  add_library(Snappy::Snappy UNKNOWN IMPORTED)
+  set_target_properties(Snappy::Snappy PROPERTIES
+    IMPORTED_LOCATION "${Snappy_LIBRARY}"
+    INTERFACE_INCLUDE_DIRECTORIES "${Snappy_INCLUDE_DIR}"
+  )
+endif()
+
+mark_as_advanced(
+  Snappy_INCLUDE_DIR
+  Snappy_LIBRARY
+)
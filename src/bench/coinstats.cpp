@@ -0,0 +1,58 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <kernel/coinstats.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstdint>
+
+static constexpr int NUM_TXS{20'000};
+static constexpr uint32_t OUTPUTS_PER_TX{3};
+
+static void ComputeUTXOStats(benchmark::Bench& bench, kernel::CoinStatsHashType hash_type, int threads)
+{
+    const auto test_setup{MakeNoLogFileContext<const TestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CCoinsViewDB db{{.path = "", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    {
+        CCoinsViewCache cache{&db};
+        for (int i = 0; i < NUM_TXS; ++i) {
+            const Txid txid{Txid::FromUint256(rng.rand256())};
+            for (uint32_t n = 0; n < OUTPUTS_PER_TX; ++n) {
+                CScript script;
+                script << OP_DUP << OP_HASH160 << rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG;
+                cache.AddCoin(COutPoint{txid, n}, Coin{CTxOut{rng.randrange(1'000'000), script}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+            }
+        }
+        cache.SetBestBlock(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip()->GetBlockHash()));
+        assert(cache.Flush());
+    }
+
+    const kernel::UTXOStatsOptions options{.threads = threads};
+    bench.batch(NUM_TXS * OUTPUTS_PER_TX).unit("coin").run([&] {
+        const auto stats{kernel::ComputeUTXOStats(hash_type, &db, test_setup->m_node.chainman->m_blockman, {}, options)};
+        assert(stats && stats->coins_count == NUM_TXS * OUTPUTS_PER_TX);
+    });
+}
+
+static void ComputeUTXOStatsHashSerialized(benchmark::Bench& bench) { ComputeUTXOStats(bench, kernel::CoinStatsHashType::HASH_SERIALIZED, /*threads=*/1); }
+static void ComputeUTXOStatsMuHash(benchmark::Bench& bench) { ComputeUTXOStats(bench, kernel::CoinStatsHashType::MUHASH, /*threads=*/1); }
+static void ComputeUTXOStatsMuHashThreads(benchmark::Bench& bench) { ComputeUTXOStats(bench, kernel::CoinStatsHashType::MUHASH, /*threads=*/4); }
+static void ComputeUTXOStatsNone(benchmark::Bench& bench) { ComputeUTXOStats(bench, kernel::CoinStatsHashType::NONE, /*threads=*/1); }
+static void ComputeUTXOStatsNoneThreads(benchmark::Bench& bench) { ComputeUTXOStats(bench, kernel::CoinStatsHashType::NONE, /*threads=*/4); }
+
+BENCHMARK(ComputeUTXOStatsHashSerialized, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ComputeUTXOStatsMuHash, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ComputeUTXOStatsMuHashThreads, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ComputeUTXOStatsNone, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ComputeUTXOStatsNoneThreads, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,154 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <random.h>
+#include <serialize.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+static constexpr size_t DB_CACHE_SIZE{8 << 20};
+static constexpr int NUM_ENTRIES{100'000};
+static constexpr int ENTRIES_PER_BATCH{1'000};
+
+static DBParams MakeParams(const BasicTestingSetup& test_setup, const DBTuning& tuning, int read_threads = 0)
+{
+    return DBParams{
+        .path = test_setup.m_args.GetDataDirBase() / "bench_db",
+        .cache_bytes = DB_CACHE_SIZE,
+        .wipe_data = true,
+        .tuning = tuning,
+        .read_threads = read_threads};
+}
+
+// Keys and values shaped like those of the transaction index: random hashes
+// mapping to small positions.
+static std::vector<std::pair<uint256, std::vector<uint8_t>>> MakeEntries(FastRandomContext& rng)
+{
+    std::vector<std::pair<uint256, std::vector<uint8_t>>> entries;
+    entries.reserve(NUM_ENTRIES);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        entries.emplace_back(rng.rand256(), rng.randbytes(12));
+    }
+    return entries;
+}
+
+static void WriteEntries(CDBWrapper& db, const std::vector<std::pair<uint256, std::vector<uint8_t>>>& entries)
+{
+    CDBBatch batch{db};
+    for (size_t i = 0; i < entries.size(); ++i) {
+        batch.Write(entries[i].first, entries[i].second);
+        if ((i + 1) % ENTRIES_PER_BATCH == 0) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    db.WriteBatch(batch);
+}
+
+static void DBWrapperWriteRandom(benchmark::Bench& bench, const DBTuning& tuning)
+{
+    const auto test_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto entries{MakeEntries(rng)};
+    bench.batch(NUM_ENTRIES).unit("entry").run([&] {
+        CDBWrapper db{MakeParams(*test_setup, tuning)};
+        WriteEntries(db, entries);
+    });
+}
+
+// Keys of entries appended in key order, like those of indexes keyed by height.
+struct HeightKey {
+    uint32_t height;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, 'h');
+        ser_writedata32be(s, height);
+    }
+};
+
+static void DBWrapperWriteSequential(benchmark::Bench& bench, const DBTuning& tuning)
+{
+    const auto test_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const std::vector<uint8_t> value{rng.randbytes(100)};
+    bench.batch(NUM_ENTRIES).unit("entry").run([&] {
+        CDBWrapper db{MakeParams(*test_setup, tuning)};
+        CDBBatch batch{db};
+        for (int i = 0; i < NUM_ENTRIES; ++i) {
+            batch.Write(HeightKey{static_cast<uint32_t>(i)}, value);
+            if ((i + 1) % ENTRIES_PER_BATCH == 0) {
+                db.WriteBatch(batch);
+                batch.Clear();
+            }
+        }
+        db.WriteBatch(batch);
+    });
+}
+
+static void DBWrapperReadRandom(benchmark::Bench& bench, const DBTuning& tuning)
+{
+    const auto test_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto entries{MakeEntries(rng)};
+    CDBWrapper db{MakeParams(*test_setup, tuning)};
+    WriteEntries(db, entries);
+
+    std::vector<uint8_t> value;
+    bench.run([&] {
+        // Mix lookups of existing and missing keys, as the bloom filters only help the latter.
+        const bool exists{db.Read(entries[rng.randrange(entries.size())].first, value)};
+        assert(exists);
+        assert(!db.Read(rng.rand256(), value));
+    });
+}
+
+static void DBWrapperReadMany(benchmark::Bench& bench, int read_threads)
+{
+    const auto test_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto entries{MakeEntries(rng)};
+    CDBWrapper db{MakeParams(*test_setup, DB_TUNING_RANDOM_ACCESS, read_threads)};
+    WriteEntries(db, entries);
+
+    // About as many lookups as the inputs of a full block.
+    std::vector<uint256> keys;
+    for (int i = 0; i < 5'000; ++i) {
+        keys.push_back(entries[rng.randrange(entries.size())].first);
+    }
+    std::vector<std::optional<std::vector<uint8_t>>> values;
+    bench.batch(keys.size()).unit("entry").run([&] {
+        db.ReadMany(keys, values);
+        assert(values.front());
+    });
+}
+
+static void DBWrapperWriteRandomRandomAccess(benchmark::Bench& bench) { DBWrapperWriteRandom(bench, DB_TUNING_RANDOM_ACCESS); }
+static void DBWrapperWriteRandomAppendMostly(benchmark::Bench& bench) { DBWrapperWriteRandom(bench, DB_TUNING_APPEND_MOSTLY); }
+static void DBWrapperWriteSequentialRandomAccess(benchmark::Bench& bench) { DBWrapperWriteSequential(bench, DB_TUNING_RANDOM_ACCESS); }
+static void DBWrapperWriteSequentialAppendMostly(benchmark::Bench& bench) { DBWrapperWriteSequential(bench, DB_TUNING_APPEND_MOSTLY); }
+static void DBWrapperReadRandomRandomAccess(benchmark::Bench& bench) { DBWrapperReadRandom(bench, DB_TUNING_RANDOM_ACCESS); }
+static void DBWrapperReadRandomAppendMostly(benchmark::Bench& bench) { DBWrapperReadRandom(bench, DB_TUNING_APPEND_MOSTLY); }
+static void DBWrapperReadRandomNoBloomFilter(benchmark::Bench& bench) { DBWrapperReadRandom(bench, DBTuning{.bloom_bits_per_key = 0}); }
+static void DBWrapperReadManySequential(benchmark::Bench& bench) { DBWrapperReadMany(bench, /*read_threads=*/0); }
+static void DBWrapperReadManyThreads(benchmark::Bench& bench) { DBWrapperReadMany(bench, /*read_threads=*/3); }
+
+BENCHMARK(DBWrapperWriteRandomRandomAccess, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperWriteRandomAppendMostly, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperWriteSequentialRandomAccess, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperWriteSequentialAppendMostly, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadRandomRandomAccess, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadRandomAppendMostly, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadRandomNoBloomFilter, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadManySequential, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadManyThreads, benchmark::PriorityLevel::HIGH);
@@ -27,28 +27,33 @@
 
 using namespace util::hex_literals;
 
-// Very simple block filter index sync benchmark, only using coinbase outputs.
-static void BlockFilterIndexSync(benchmark::Bench& bench)
-{
-    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+static constexpr int CHAIN_SIZE{600};
 
-    // Create more blocks
-    int CHAIN_SIZE = 600;
+// Extend the test chain to CHAIN_SIZE blocks, only using coinbase outputs.
+static void CreateChain(TestChain100Setup& test_setup)
+{
     CPubKey pubkey{"02ed26169896db86ced4cbb7b3ecef9859b5952825adbeab998fb5b307e54949c9"_hex_u8};
     CScript script = GetScriptForDestination(WitnessV0KeyHash(pubkey));
     std::vector<CMutableTransaction> noTxns;
     for (int i = 0; i < CHAIN_SIZE - 100; i++) {
-        test_setup->CreateAndProcessBlock(noTxns, script);
+        test_setup.CreateAndProcessBlock(noTxns, script);
         SetMockTime(GetTime() + 1);
     }
-    assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+    assert(WITH_LOCK(::cs_main, return test_setup.m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+}
+
+// Very simple block filter index sync benchmark, only using coinbase outputs.
+static void RunBlockFilterIndexSync(benchmark::Bench& bench, int workers)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CreateChain(*test_setup);
 
     bench.minEpochIterations(5).run([&] {
         BlockFilterIndex filter_index(interfaces::MakeChain(test_setup->m_node), BlockFilterType::BASIC,
                                       /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true);
         assert(filter_index.Init());
         assert(!filter_index.BlockUntilSyncedToCurrentChain());
-        filter_index.Sync();
+        filter_index.Sync(workers);
 
         IndexSummary summary = filter_index.GetSummary();
         assert(summary.synced);
@@ -56,4 +61,62 @@ static void BlockFilterIndexSync(benchmark::Bench& bench)
     });
 }
 
+static void BlockFilterIndexSync(benchmark::Bench& bench)
+{
+    RunBlockFilterIndexSync(bench, /*workers=*/0);
+}
+
+// Same, reading blocks and computing filters ahead on a pool of worker threads.
+static void BlockFilterIndexSyncParallel(benchmark::Bench& bench)
+{
+    RunBlockFilterIndexSync(bench, /*workers=*/4);
+}
+
+// Look up the filters of the whole chain, as done when serving getcfilters requests.
+static void RunBlockFilterIndexLookupRange(benchmark::Bench& bench, size_t cache_size, bool to_block_filters)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CreateChain(*test_setup);
+
+    BlockFilterIndex filter_index(interfaces::MakeChain(test_setup->m_node), BlockFilterType::BASIC,
+                                  cache_size, /*f_memory=*/false, /*f_wipe=*/true);
+    assert(filter_index.Init());
+    filter_index.Sync();
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip())};
+
+    bench.run([&] {
+        if (to_block_filters) {
+            std::vector<BlockFilter> filters;
+            assert(filter_index.LookupFilterRange(0, tip, filters));
+            assert(filters.size() == CHAIN_SIZE + 1U);
+        } else {
+            std::vector<EncodedBlockFilter> filters;
+            assert(filter_index.LookupEncodedFilterRange(0, tip, filters));
+            assert(filters.size() == CHAIN_SIZE + 1U);
+        }
+    });
+}
+
+// Filters read from disk each time.
+static void BlockFilterIndexLookupRange(benchmark::Bench& bench)
+{
+    RunBlockFilterIndexLookupRange(bench, /*cache_size=*/0, /*to_block_filters=*/false);
+}
+
+// Filters served from the filter cache.
+static void BlockFilterIndexLookupRangeCached(benchmark::Bench& bench)
+{
+    RunBlockFilterIndexLookupRange(bench, /*cache_size=*/16 << 20, /*to_block_filters=*/false);
+}
+
+// Filters read from disk each time, and copied into BlockFilter objects.
+static void BlockFilterIndexLookupFilterRange(benchmark::Bench& bench)
+{
+    RunBlockFilterIndexLookupRange(bench, /*cache_size=*/0, /*to_block_filters=*/true);
+}
+
 BENCHMARK(BlockFilterIndexSync, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexSyncParallel, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexLookupRange, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexLookupRangeCached, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexLookupFilterRange, benchmark::PriorityLevel::HIGH);
@@ -7,6 +7,7 @@
 #include <chainparams.h>
 #include <flatfile.h>
 #include <node/blockstorage.h>
+#include <primitives/block.h>
 #include <span.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -14,6 +15,7 @@
 #include <util/fs.h>
 #include <validation.h>
 
+#include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <map>
@@ -72,4 +74,35 @@ static void LoadExternalBlockFile(benchmark::Bench& bench)
     fs::remove(blkfile);
 }
 
+/**
+ * During -reindex and -loadblock, the blocks found by LoadExternalBlockFile()
+ * are deserialized and checked by the threads of the BlockLoader of the
+ * ChainstateManager, ahead of being accepted.
+ *
+ * This benchmark measures the throughput of this stage, loading as many
+ * blocks at once as LoadExternalBlockFile() does.
+ */
+static void LoadExternalBlockFileBlockLoader(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    BlockLoader& loader{testing_setup->m_node.chainman->m_block_loader};
+
+    std::vector<std::shared_ptr<BlockLoader::Job>> jobs;
+    bench.batch(MAX_BLOCKS_LOADED_AHEAD).unit("block").run([&] {
+        for (size_t i = 0; i < MAX_BLOCKS_LOADED_AHEAD; ++i) {
+            jobs.push_back(loader.Add([](CBlock& block) {
+                DataStream stream{benchmark::data::block413567};
+                stream >> TX_WITH_WITNESS(block);
+                return true;
+            }));
+        }
+        for (const auto& job : jobs) {
+            loader.Wait(*job);
+            assert(job->block && job->block->fChecked);
+        }
+        jobs.clear();
+    });
+}
+
 BENCHMARK(LoadExternalBlockFile, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LoadExternalBlockFileBlockLoader, benchmark::PriorityLevel::HIGH);
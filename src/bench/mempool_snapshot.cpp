@@ -0,0 +1,109 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+static constexpr int NUM_READERS{2};
+static constexpr int POOL_SIZE{1000};
+static constexpr int WRITER_BATCH{10};
+
+static CTransactionRef MakeTx(uint32_t n)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout.n = n;
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = n;
+    return MakeTransactionRef(tx);
+}
+
+static void AddTx(const CTransactionRef& tx, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    pool.addUnchecked(CTxMemPoolEntry(tx, /*fee=*/1000, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, LockPoints{}));
+}
+
+/** Measure how fast a writer can add and remove batches of transactions while
+ * readers continuously list the mempool and look up single transactions, either
+ * under cs or through published snapshots. */
+static void MempoolReadContention(benchmark::Bench& bench, bool use_snapshot)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    {
+        LOCK2(cs_main, pool.cs);
+        for (int i = 0; i < POOL_SIZE; ++i) {
+            AddTx(MakeTx(i), pool);
+        }
+    }
+    const Txid lookup{MakeTx(0)->GetHash()};
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; ++i) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                size_t found{0};
+                if (use_snapshot) {
+                    found += pool.GetSnapshot()->entries.size();
+                    found += pool.GetSnapshotEntry(lookup).has_value();
+                } else {
+                    {
+                        LOCK(pool.cs);
+                        found += pool.entryAll().size();
+                    }
+                    LOCK(pool.cs);
+                    found += pool.GetEntry(lookup) != nullptr;
+                }
+                Assert(found > 0);
+            }
+        });
+    }
+
+    std::vector<CTransactionRef> batch;
+    for (int i = 0; i < WRITER_BATCH; ++i) {
+        batch.push_back(MakeTx(POOL_SIZE + i));
+    }
+    bench.batch(WRITER_BATCH).unit("tx").run([&] {
+        LOCK2(cs_main, pool.cs);
+        for (const auto& tx : batch) {
+            AddTx(tx, pool);
+        }
+        for (const auto& tx : batch) {
+            pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED);
+        }
+    });
+
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+}
+
+static void MempoolReadContentionLocked(benchmark::Bench& bench)
+{
+    MempoolReadContention(bench, /*use_snapshot=*/false);
+}
+
+static void MempoolReadContentionSnapshot(benchmark::Bench& bench)
+{
+    MempoolReadContention(bench, /*use_snapshot=*/true);
+}
+
+BENCHMARK(MempoolReadContentionLocked, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolReadContentionSnapshot, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,125 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <common/args.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_entry.h>
+#include <policy/fees.h>
+#include <policy/fees_args.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+static constexpr int64_t TX_VSIZE{200};
+static constexpr int TXS_PER_BLOCK{200};
+
+static CTransactionRef MakeUniqueTx(uint32_t n)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout.n = n;
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = 0;
+    return MakeTransactionRef(tx);
+}
+
+/** Confirm the higher paying half of the outstanding transactions, expire the
+ * ones that have been waiting for too long, and feed the estimator one block
+ * worth of new mempool transactions at a spread of feerates. */
+static void ProcessBlock(CBlockPolicyEstimator& estimator, unsigned int height, uint32_t& tx_counter, std::vector<TransactionInfo>& unconfirmed)
+{
+    std::vector<RemovedMempoolTransactionInfo> removed;
+    std::vector<TransactionInfo> still_unconfirmed;
+    for (const auto& info : unconfirmed) {
+        if (info.m_fee >= TX_VSIZE * 20) {
+            removed.emplace_back(CTxMemPoolEntry{info.m_tx, info.m_fee, /*time=*/0, info.txHeight, /*entry_sequence=*/0,
+                                                 /*spends_coinbase=*/false, /*sigops_cost=*/4, LockPoints{}});
+        } else if (info.txHeight + 10 < height) {
+            estimator.removeTx(info.m_tx->GetHash());
+        } else {
+            still_unconfirmed.push_back(info);
+        }
+    }
+    estimator.processBlock(removed, height);
+    unconfirmed = std::move(still_unconfirmed);
+
+    for (int i = 0; i < TXS_PER_BLOCK; ++i) {
+        const CAmount fee{TX_VSIZE * (1 + (i % 40))};
+        const auto tx{MakeUniqueTx(tx_counter++)};
+        estimator.processTransaction(NewMempoolTransactionInfo{tx, fee, TX_VSIZE, height,
+                                                               /*mempool_limit_bypassed=*/false,
+                                                               /*submitted_in_package=*/false,
+                                                               /*chainstate_is_current=*/true,
+                                                               /*has_no_mempool_parents=*/true});
+        unconfirmed.emplace_back(tx, fee, TX_VSIZE, height);
+    }
+}
+
+static std::unique_ptr<CBlockPolicyEstimator> MakeWarmEstimator(const ArgsManager& args, unsigned int& height, uint32_t& tx_counter, std::vector<TransactionInfo>& unconfirmed)
+{
+    auto estimator{std::make_unique<CBlockPolicyEstimator>(FeeestPath(args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES)};
+    // Run long enough for the long horizon circular buffer to wrap
+    for (height = 1; height <= 1100; ++height) {
+        ProcessBlock(*estimator, height, tx_counter, unconfirmed);
+    }
+    return estimator;
+}
+
+static void PolicyEstimatorProcessBlock(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    unsigned int height{0};
+    uint32_t tx_counter{0};
+    std::vector<TransactionInfo> unconfirmed;
+    const auto estimator{MakeWarmEstimator(*Assert(testing_setup->m_node.args), height, tx_counter, unconfirmed)};
+
+    bench.batch(TXS_PER_BLOCK).unit("tx").run([&] {
+        ProcessBlock(*estimator, height++, tx_counter, unconfirmed);
+    });
+}
+
+static void PolicyEstimatorSmartFee(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    unsigned int height{0};
+    uint32_t tx_counter{0};
+    std::vector<TransactionInfo> unconfirmed;
+    const auto estimator{MakeWarmEstimator(*Assert(testing_setup->m_node.args), height, tx_counter, unconfirmed)};
+
+    int target{1};
+    bench.run([&] {
+        FeeCalculation fee_calc;
+        (void)estimator->estimateSmartFee(target, &fee_calc, /*conservative=*/target % 2 == 0);
+        target = target % 144 + 1;
+    });
+}
+
+static void PolicyEstimatorRawFee(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    unsigned int height{0};
+    uint32_t tx_counter{0};
+    std::vector<TransactionInfo> unconfirmed;
+    const auto estimator{MakeWarmEstimator(*Assert(testing_setup->m_node.args), height, tx_counter, unconfirmed)};
+
+    int target{1};
+    bench.run([&] {
+        EstimationResult result;
+        (void)estimator->estimateRawFee(target, /*successThreshold=*/0.95, FeeEstimateHorizon::LONG_HALFLIFE, &result);
+        target = target % 1008 + 1;
+    });
+}
+
+BENCHMARK(PolicyEstimatorProcessBlock, benchmark::PriorityLevel::HIGH);
+BENCHMARK(PolicyEstimatorSmartFee, benchmark::PriorityLevel::HIGH);
+BENCHMARK(PolicyEstimatorRawFee, benchmark::PriorityLevel::HIGH);
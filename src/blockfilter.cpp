@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <array>
 #include <mutex>
 #include <set>
 
@@ -34,9 +35,26 @@ std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) cons
 {
     std::vector<uint64_t> hashed_elements;
     hashed_elements.reserve(elements.size());
+
+    // Hash elements in small batches, which are hashed several at a time, while the batch itself
+    // stays in cache.
+    std::array<Span<const unsigned char>, 64> batch;
+    std::array<uint64_t, 64> hashes;
+    size_t batch_size = 0;
+    const auto hash_batch = [&] {
+        SipHashBatch(m_params.m_siphash_k0, m_params.m_siphash_k1,
+                     Span{batch}.first(batch_size), Span{hashes}.first(batch_size));
+        for (size_t i = 0; i < batch_size; ++i) {
+            hashed_elements.push_back(FastRange64(hashes[i], m_F));
+        }
+        batch_size = 0;
+    };
     for (const Element& element : elements) {
-        hashed_elements.push_back(HashToRange(element));
+        batch[batch_size++] = element;
+        if (batch_size == batch.size()) hash_batch();
     }
+    hash_batch();
+
     std::sort(hashed_elements.begin(), hashed_elements.end());
     return hashed_elements;
 }
@@ -61,11 +79,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    GolombRiceDecoder decoder{Span{m_encoded}.subspan(GetSizeOfCompactSize(N))};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        decoder.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (!decoder.Exhausted()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -88,16 +106,16 @@ GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
         return;
     }
 
-    BitStreamWriter bitwriter{stream};
+    GolombRiceEncoder encoder{m_encoded};
 
     uint64_t last_value = 0;
     for (uint64_t value : BuildHashedSet(elements)) {
         uint64_t delta = value - last_value;
-        GolombRiceEncode(bitwriter, m_params.m_P, delta);
+        encoder.Encode(m_params.m_P, delta);
         last_value = value;
     }
 
-    bitwriter.Flush();
+    encoder.Flush();
 }
 
 bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
@@ -108,12 +126,12 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader bitreader{stream};
+    GolombRiceDecoder decoder{Span{m_encoded}.subspan(GetSizeOfCompactSize(N))};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = decoder.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -11,6 +11,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -126,14 +128,14 @@ public:
     //! Mutex to ensure only one concurrent CCheckQueueControl
     Mutex m_control_mutex;
 
-    //! Create a new check queue
-    explicit CCheckQueue(unsigned int batch_size, int worker_threads_num)
+    //! Create a new check queue, whose worker threads are named after thread_name
+    explicit CCheckQueue(unsigned int batch_size, int worker_threads_num, std::string_view thread_name = "scriptch")
         : nBatchSize(batch_size)
     {
         m_worker_threads.reserve(worker_threads_num);
         for (int n = 0; n < worker_threads_num; ++n) {
-            m_worker_threads.emplace_back([this, n]() {
-                util::ThreadRename(strprintf("scriptch.%i", n));
+            m_worker_threads.emplace_back([this, n, name = std::string{thread_name}]() {
+                util::ThreadRename(strprintf("%s.%i", name, n));
                 Loop(false /* worker thread */);
             });
         }
@@ -14,6 +14,16 @@ uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
 bool CCoinsView::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) { return false; }
 std::unique_ptr<CCoinsViewCursor> CCoinsView::Cursor() const { return nullptr; }
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsView::Cursors(Span<const Txid> starts) const { return {}; }
+
+void CCoinsView::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const
+{
+    coins.assign(outpoints.size(), std::nullopt);
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        Coin coin;
+        if (GetCoin(outpoints[i], coin)) coins[i] = std::move(coin);
+    }
+}
 
 bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
 {
@@ -23,12 +33,14 @@ bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
 
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 bool CCoinsViewBacked::GetCoin(const COutPoint &outpoint, Coin &coin) const { return base->GetCoin(outpoint, coin); }
+void CCoinsViewBacked::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const { base->GetCoins(outpoints, coins); }
 bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->HaveCoin(outpoint); }
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
 void CCoinsViewBacked::SetBackend(CCoinsView &viewIn) { base = &viewIn; }
 bool CCoinsViewBacked::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) { return base->BatchWrite(cursor, hashBlock); }
 std::unique_ptr<CCoinsViewCursor> CCoinsViewBacked::Cursor() const { return base->Cursor(); }
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewBacked::Cursors(Span<const Txid> starts) const { return base->Cursors(starts); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
 CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic) :
@@ -58,6 +70,29 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const
     return ret;
 }
 
+void CCoinsViewCache::FetchCoins(Span<const COutPoint> outpoints) const
+{
+    std::vector<COutPoint> missing;
+    for (const COutPoint& outpoint : outpoints) {
+        if (!cacheCoins.count(outpoint)) missing.push_back(outpoint);
+    }
+    if (missing.empty()) return;
+    std::vector<std::optional<Coin>> coins;
+    base->GetCoins(missing, coins);
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (!coins[i]) continue;
+        // Outpoints given more than once are only inserted the first time.
+        const auto [it, inserted] = cacheCoins.try_emplace(missing[i]);
+        if (!inserted) continue;
+        it->second.coin = std::move(*coins[i]);
+        if (it->second.coin.IsSpent()) {
+            // The parent only has an empty entry for this outpoint; we can consider our version as fresh.
+            it->second.AddFlags(CCoinsCacheEntry::FRESH, *it, m_sentinel);
+        }
+        cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+    }
+}
+
 bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
     if (it != cacheCoins.end()) {
@@ -67,6 +102,16 @@ bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return false;
 }
 
+void CCoinsViewCache::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const
+{
+    FetchCoins(outpoints);
+    coins.assign(outpoints.size(), std::nullopt);
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        const auto it{cacheCoins.find(outpoints[i])};
+        if (it != cacheCoins.end() && !it->second.coin.IsSpent()) coins[i] = it->second.coin;
+    }
+}
+
 void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possible_overwrite) {
     assert(!coin.IsSpent());
     if (coin.out.scriptPubKey.IsUnspendable()) return;
@@ -385,6 +430,10 @@ bool CCoinsViewErrorCatcher::GetCoin(const COutPoint &outpoint, Coin &coin) cons
     return ExecuteBackedWrapper([&]() { return CCoinsViewBacked::GetCoin(outpoint, coin); }, m_err_callbacks);
 }
 
+void CCoinsViewErrorCatcher::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const {
+    ExecuteBackedWrapper([&]() { CCoinsViewBacked::GetCoins(outpoints, coins); return true; }, m_err_callbacks);
+}
+
 bool CCoinsViewErrorCatcher::HaveCoin(const COutPoint &outpoint) const {
     return ExecuteBackedWrapper([&]() { return CCoinsViewBacked::HaveCoin(outpoint); }, m_err_callbacks);
 }
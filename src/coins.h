@@ -14,13 +14,16 @@
 #include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <span.h>
 #include <util/hasher.h>
 
 #include <assert.h>
 #include <stdint.h>
 
 #include <functional>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 /**
  * A UTXO entry.
@@ -309,6 +312,13 @@ public:
      */
     virtual bool GetCoin(const COutPoint &outpoint, Coin &coin) const;
 
+    /** Retrieve the Coins for many outpoints at once, which views backed by a
+     *  database may look up more efficiently than one at a time.
+     *  coins[i] is set to the unspent coin for outpoints[i] if one was found,
+     *  and to std::nullopt otherwise.
+     */
+    virtual void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const;
+
     //! Just check whether a given outpoint is unspent.
     virtual bool HaveCoin(const COutPoint &outpoint) const;
 
@@ -328,6 +338,12 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get cursors that iterate over the same state from different positions,
+    //! e.g. to process separate ranges in parallel. Each cursor starts at the
+    //! first coin of a transaction whose txid is not less than its element of
+    //! starts. Returns no cursors if not supported.
+    virtual std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(Span<const Txid> starts) const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() = default;
 
@@ -345,12 +361,14 @@ protected:
 public:
     CCoinsViewBacked(CCoinsView *viewIn);
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(Span<const Txid> starts) const override;
     size_t EstimateSize() const override;
 };
 
@@ -385,6 +403,7 @@ public:
 
     // Standard CCoinsView methods
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
@@ -392,6 +411,9 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(Span<const Txid> starts) const override {
+        throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
+    }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
@@ -400,6 +422,17 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Load the coins for the given outpoints into the cache, looking up all
+     * those not cached yet with a single call to the backing CCoinsView.
+     * This is more efficient than fetching them one at a time when they are
+     * known upfront, e.g. the inputs of a block.
+     *
+     * @note this is marked const, but may actually append to `cacheCoins`, increasing
+     * memory usage.
+     */
+    void FetchCoins(Span<const COutPoint> outpoints) const;
+
     /**
      * Return a reference to Coin in the cache, or coinEmpty if not found. This is
      * more efficient than GetCoin.
@@ -515,6 +548,7 @@ public:
     }
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
 
 private:
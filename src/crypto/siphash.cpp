@@ -4,7 +4,12 @@
 
 #include <crypto/siphash.h>
 
+#include <crypto/common.h>
+
+#include <algorithm>
+#include <array>
 #include <bit>
+#include <cassert>
 
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
@@ -172,3 +177,90 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+/** SipHash-2-4 state of one message hashed by SipHashBatch. */
+struct SipHashLane {
+    uint64_t v0, v1, v2, v3;
+
+    void Init(uint64_t k0, uint64_t k1)
+    {
+        v0 = 0x736f6d6570736575ULL ^ k0;
+        v1 = 0x646f72616e646f6dULL ^ k1;
+        v2 = 0x6c7967656e657261ULL ^ k0;
+        v3 = 0x7465646279746573ULL ^ k1;
+    }
+
+    void Round() { SIPROUND; }
+
+    void Compress(uint64_t m)
+    {
+        v3 ^= m;
+        Round();
+        Round();
+        v0 ^= m;
+    }
+};
+
+/** The last word of a message: its remaining bytes and, in the top byte, its size. */
+uint64_t LastWord(Span<const unsigned char> data)
+{
+    uint64_t t = uint64_t{static_cast<uint8_t>(data.size())} << 56;
+    const size_t tail{data.size() & 7};
+    const unsigned char* ptr{data.data() + data.size() - tail};
+    for (size_t i = 0; i < tail; ++i) {
+        t |= uint64_t{ptr[i]} << (8 * i);
+    }
+    return t;
+}
+
+template <size_t LANES>
+void SipHashLanes(uint64_t k0, uint64_t k1, const Span<const unsigned char>* data, uint64_t* out)
+{
+    std::array<SipHashLane, LANES> lanes;
+    size_t common_words{data[0].size() / 8};
+    for (size_t l = 0; l < LANES; ++l) {
+        lanes[l].Init(k0, k1);
+        common_words = std::min(common_words, data[l].size() / 8);
+    }
+
+    // Words all messages have are compressed in lockstep.
+    for (size_t w = 0; w < common_words; ++w) {
+        for (size_t l = 0; l < LANES; ++l) {
+            lanes[l].Compress(ReadLE64(data[l].data() + 8 * w));
+        }
+    }
+    for (size_t l = 0; l < LANES; ++l) {
+        for (size_t w = common_words; w < data[l].size() / 8; ++w) {
+            lanes[l].Compress(ReadLE64(data[l].data() + 8 * w));
+        }
+    }
+
+    for (size_t l = 0; l < LANES; ++l) {
+        lanes[l].Compress(LastWord(data[l]));
+        lanes[l].v2 ^= 0xFF;
+    }
+    for (int r = 0; r < 4; ++r) {
+        for (size_t l = 0; l < LANES; ++l) {
+            lanes[l].Round();
+        }
+    }
+    for (size_t l = 0; l < LANES; ++l) {
+        out[l] = lanes[l].v0 ^ lanes[l].v1 ^ lanes[l].v2 ^ lanes[l].v3;
+    }
+}
+
+} // namespace
+
+void SipHashBatch(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> data, Span<uint64_t> out)
+{
+    assert(out.size() == data.size());
+    size_t i{0};
+    for (; i + 4 <= data.size(); i += 4) {
+        SipHashLanes<4>(k0, k1, data.data() + i, out.data() + i);
+    }
+    for (; i < data.size(); ++i) {
+        SipHashLanes<1>(k0, k1, data.data() + i, out.data() + i);
+    }
+}
@@ -45,4 +45,12 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Compute the SipHash-2-4 of many messages with the same key.
+ *
+ *  out[i] is identical to CSipHasher(k0, k1).Write(data[i]).Finalize(). Messages
+ *  are consumed 8 bytes at a time and hashed 4 at a time, interleaved, so that
+ *  the rounds of independent messages can execute in parallel.
+ */
+void SipHashBatch(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> data, Span<uint64_t> out);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
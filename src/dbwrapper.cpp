@@ -4,16 +4,24 @@
 
 #include <dbwrapper.h>
 
+#include <checkqueue.h>
+#include <crypto/common.h>
 #include <logging.h>
 #include <random.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <sync.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
+#include <util/string.h>
+#include <util/thread.h>
+#include <util/threadinterrupt.h>
+#include <util/time.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdarg>
 #include <cstdint>
@@ -28,10 +36,29 @@
 #include <leveldb/slice.h>
 #include <leveldb/status.h>
 #include <leveldb/write_batch.h>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <string_view>
+#include <thread>
 #include <utility>
 
+using namespace std::chrono_literals;
+
+//! Time without writes after which a database is considered idle
+static constexpr auto DB_IDLE_TIME{30s};
+//! Interval at which a database compacted when idle checks whether it is
+static constexpr auto DB_IDLE_CHECK_INTERVAL{10s};
+//! Amount of data compacted at once while a database is idle
+static constexpr size_t DB_IDLE_COMPACTION_STEP{64 << 20};
+
+// Compaction triggers and level sizes of LevelDB (see leveldb/db/dbformat.h and
+// leveldb/db/version_set.cc), used to tell whether compactions are pending.
+static constexpr int LEVELDB_L0_COMPACTION_TRIGGER{4};
+static constexpr int LEVELDB_L0_SLOWDOWN_WRITES_TRIGGER{8};
+static constexpr uint64_t LEVELDB_L1_MAX_BYTES{10 << 20};
+
 static auto CharCast(const std::byte* data) { return reinterpret_cast<const char*>(data); }
 
 bool DestroyDB(const std::string& path_str)
@@ -109,6 +136,62 @@ public:
     }
 };
 
+/** Environment limiting the rate at which table files are written, which is
+ * mostly done by compactions. Flushes of the write buffer to level 0 are
+ * limited too, so the rate should stay well above the rate at which the
+ * database is written to. */
+class RateLimitedEnv final : public leveldb::EnvWrapper
+{
+private:
+    class File final : public leveldb::WritableFile
+    {
+    private:
+        RateLimitedEnv& m_env;
+        const std::unique_ptr<leveldb::WritableFile> m_file;
+
+    public:
+        File(RateLimitedEnv& env, leveldb::WritableFile* file) : m_env{env}, m_file{file} {}
+
+        leveldb::Status Append(const leveldb::Slice& data) override
+        {
+            m_env.Throttle(data.size());
+            return m_file->Append(data);
+        }
+        leveldb::Status Close() override { return m_file->Close(); }
+        leveldb::Status Flush() override { return m_file->Flush(); }
+        leveldb::Status Sync() override { return m_file->Sync(); }
+        std::string GetName() const override { return m_file->GetName(); }
+    };
+
+    const uint64_t m_bytes_per_second;
+    Mutex m_mutex;
+    //! Time until which the data written so far is allowed to take
+    SteadyClock::time_point m_next_free GUARDED_BY(m_mutex){};
+
+    void Throttle(size_t bytes) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        SteadyClock::time_point wait_until;
+        {
+            LOCK(m_mutex);
+            wait_until = std::max(m_next_free, SteadyClock::now());
+            m_next_free = wait_until + std::chrono::microseconds{bytes * 1'000'000 / m_bytes_per_second};
+        }
+        std::this_thread::sleep_until(wait_until);
+    }
+
+public:
+    RateLimitedEnv(leveldb::Env* env, uint64_t bytes_per_second) : leveldb::EnvWrapper{env}, m_bytes_per_second{bytes_per_second} {}
+
+    leveldb::Status NewWritableFile(const std::string& fname, leveldb::WritableFile** result) override
+    {
+        leveldb::Status status{target()->NewWritableFile(fname, result)};
+        if (status.ok() && fname.ends_with(".ldb")) {
+            *result = new File(*this, *result);
+        }
+        return status;
+    }
+};
+
 static void SetMaxOpenFiles(leveldb::Options *options) {
     // On most platforms the default setting of max_open_files (which is 1000)
     // is optimal. On Windows using a large file count is OK because the handles
@@ -134,13 +217,18 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBTuning& tuning)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
+    options.block_cache = leveldb::NewLRUCache(nCacheSize / 100 * tuning.block_cache_percent);
+    options.write_buffer_size = nCacheSize / 100 * tuning.write_buffer_percent;
+    if (tuning.bloom_bits_per_key > 0) {
+        options.filter_policy = leveldb::NewBloomFilterPolicy(tuning.bloom_bits_per_key);
+    }
+    options.compression = tuning.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+    if (tuning.max_file_size > 0) {
+        options.max_file_size = tuning.max_file_size;
+    }
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -195,6 +283,38 @@ void CDBBatch::EraseImpl(Span<const std::byte> key)
     size_estimate += 2 + (slKey.size() > 127) + slKey.size();
 }
 
+//! Number of keys looked up by each task of ReadMany()
+static constexpr size_t READ_MANY_CHUNK_SIZE{64};
+
+namespace {
+//! Lookups of some of the keys of a ReadMany() call, in key order
+struct ReadManyCheck {
+    leveldb::DB* db;
+    const leveldb::ReadOptions* options;
+    const std::vector<leveldb::Slice>* keys;
+    //! Indices of the keys to look up
+    Span<const size_t> indices;
+    std::vector<std::optional<std::string>>* values;
+    //! Set to the status of the lookup that failed, if any
+    leveldb::Status* error;
+
+    bool operator()()
+    {
+        for (const size_t i : indices) {
+            std::string value;
+            const leveldb::Status status{db->Get(*options, (*keys)[i], &value)};
+            if (status.ok()) {
+                (*values)[i] = std::move(value);
+            } else if (!status.IsNotFound()) {
+                *error = status;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+} // namespace
+
 struct LevelDBContext {
     //! custom environment this database is using (may be nullptr in case of default environment)
     leveldb::Env* penv;
@@ -216,17 +336,39 @@ struct LevelDBContext {
 
     //! the database itself
     leveldb::DB* pdb;
+
+    //! time of the last write, to tell whether the database is idle
+    std::atomic<SteadyClock::time_point> last_write{SteadyClock::now()};
+
+    //! time spent in writes slowed down by pending compactions, in microseconds
+    std::atomic<int64_t> stall_micros{0};
+
+    Mutex compact_mutex;
+
+    //! first 8 bytes of the key the next compaction step starts at
+    uint64_t compact_cursor GUARDED_BY(compact_mutex){0};
+
+    //! thread compacting the database when it is idle, if any
+    std::thread compact_thread;
+    CThreadInterrupt compact_interrupt;
+
+    //! threads issuing the lookups of ReadMany(), if any
+    std::unique_ptr<CCheckQueue<ReadManyCheck>> read_queue;
 };
 
 CDBWrapper::CDBWrapper(const DBParams& params)
     : m_db_context{std::make_unique<LevelDBContext>()}, m_name{fs::PathToString(params.path.stem())}, m_path{params.path}, m_is_memory{params.memory_only}
 {
     DBContext().penv = nullptr;
+    DBContext().pdb = nullptr;
     DBContext().readoptions.verify_checksums = true;
     DBContext().iteroptions.verify_checksums = true;
     DBContext().iteroptions.fill_cache = false;
     DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
+    DBContext().options = GetOptions(params.cache_bytes, params.tuning);
+    LogDebug(BCLog::LEVELDB, "LevelDB using block_cache=%d write_buffer_size=%d compression=%d bloom_bits_per_key=%d max_file_size=%d for %s\n",
+             params.cache_bytes / 100 * params.tuning.block_cache_percent, DBContext().options.write_buffer_size,
+             params.tuning.compression, params.tuning.bloom_bits_per_key, DBContext().options.max_file_size, m_name);
     DBContext().options.create_if_missing = true;
     if (params.memory_only) {
         DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -239,6 +381,10 @@ CDBWrapper::CDBWrapper(const DBParams& params)
         }
         TryCreateDirectories(params.path);
         LogPrintf("Opening LevelDB in %s\n", fs::PathToString(params.path));
+        if (params.options.max_compaction_rate > 0) {
+            DBContext().penv = new RateLimitedEnv(leveldb::Env::Default(), params.options.max_compaction_rate);
+            DBContext().options.env = DBContext().penv;
+        }
     }
     // PathToString() return value is safe to pass to leveldb open function,
     // because on POSIX leveldb passes the byte string directly to ::open(), and
@@ -272,10 +418,22 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     }
 
     LogPrintf("Using obfuscation key for %s: %s\n", fs::PathToString(params.path), HexStr(obfuscate_key));
+
+    if (params.compact_when_idle && !params.memory_only) {
+        DBContext().compact_thread = std::thread(&util::TraceThread, "dbcompact", [this] { CompactWhenIdle(); });
+    }
+    if (params.read_threads > 0) {
+        DBContext().read_queue = std::make_unique<CCheckQueue<ReadManyCheck>>(/*batch_size=*/1, params.read_threads, "dbread");
+    }
 }
 
 CDBWrapper::~CDBWrapper()
 {
+    if (DBContext().compact_thread.joinable()) {
+        DBContext().compact_interrupt();
+        DBContext().compact_thread.join();
+    }
+    DBContext().read_queue.reset();
     delete DBContext().pdb;
     DBContext().pdb = nullptr;
     delete DBContext().options.filter_policy;
@@ -295,8 +453,17 @@ bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
     if (log_memory) {
         mem_before = DynamicMemoryUsage() / 1024.0 / 1024;
     }
+    // LevelDB slows down writes while level 0 has too many files, and stalls them if there are more still.
+    std::string level0_files;
+    const bool slowed_down{DBContext().pdb->GetProperty("leveldb.num-files-at-level0", &level0_files) &&
+                           ToIntegral<int>(level0_files).value_or(0) >= LEVELDB_L0_SLOWDOWN_WRITES_TRIGGER};
+    const auto start{SteadyClock::now()};
     leveldb::Status status = DBContext().pdb->Write(fSync ? DBContext().syncoptions : DBContext().writeoptions, &batch.m_impl_batch->batch);
     HandleError(status);
+    DBContext().last_write = SteadyClock::now();
+    if (slowed_down) {
+        DBContext().stall_micros += Ticks<std::chrono::microseconds>(DBContext().last_write.load() - start);
+    }
     if (log_memory) {
         double mem_after = DynamicMemoryUsage() / 1024.0 / 1024;
         LogDebug(BCLog::LEVELDB, "WriteBatch memory usage: db=%s, before=%.1fMiB, after=%.1fMiB\n",
@@ -316,6 +483,108 @@ size_t CDBWrapper::DynamicMemoryUsage() const
     return parsed.value();
 }
 
+DBCompactionStats CDBWrapper::GetCompactionStats() const
+{
+    DBCompactionStats stats;
+
+    // Lines are either "--- level <n> ---" or " <file number>:<file size>[<smallest key> .. <largest key>]"
+    std::string sstables;
+    if (DBContext().pdb->GetProperty("leveldb.sstables", &sstables)) {
+        for (const std::string_view line : util::Split<std::string_view>(sstables, '\n')) {
+            if (line.starts_with("--- level ")) {
+                stats.levels.emplace_back();
+            } else if (!stats.levels.empty() && line.starts_with(' ')) {
+                const auto colon{line.find(':')}, bracket{line.find('[')};
+                if (colon == std::string_view::npos || bracket == std::string_view::npos || bracket < colon) continue;
+                stats.levels.back().files += 1;
+                stats.levels.back().bytes += ToIntegral<uint64_t>(line.substr(colon + 1, bracket - colon - 1)).value_or(0);
+            }
+        }
+    }
+
+    // Below a header, lines are "<level> <files> <size> <time> <read> <write>", with sizes in MiB
+    // and time in seconds, for levels which have files or were compacted into.
+    std::string level_stats;
+    if (DBContext().pdb->GetProperty("leveldb.stats", &level_stats)) {
+        for (const std::string_view line : util::Split<std::string_view>(level_stats, '\n')) {
+            std::vector<int64_t> fields;
+            for (const std::string_view field : util::Split<std::string_view>(line, ' ')) {
+                if (field.empty()) continue;
+                const auto value{ToIntegral<int64_t>(field)};
+                if (!value) break;
+                fields.push_back(*value);
+            }
+            if (fields.size() != 6 || fields[0] < 0 || size_t(fields[0]) >= stats.levels.size()) continue;
+            auto& level{stats.levels[fields[0]]};
+            level.compaction_time = std::chrono::seconds{fields[3]};
+            level.bytes_read = uint64_t(fields[4]) << 20;
+            level.bytes_written = uint64_t(fields[5]) << 20;
+        }
+    }
+
+    uint64_t max_bytes{LEVELDB_L1_MAX_BYTES};
+    for (size_t i = 0; i < stats.levels.size(); ++i) {
+        const auto& level{stats.levels[i]};
+        if (i == 0) {
+            if (level.files >= LEVELDB_L0_COMPACTION_TRIGGER) stats.pending_bytes += level.bytes;
+        } else if (i + 1 < stats.levels.size()) {
+            // The last level has no maximum size
+            if (level.bytes > max_bytes) stats.pending_bytes += level.bytes - max_bytes;
+            max_bytes *= 10;
+        }
+    }
+
+    stats.stall_time = std::chrono::microseconds{DBContext().stall_micros.load()};
+    return stats;
+}
+
+bool CDBWrapper::CompactStep(size_t max_bytes)
+{
+    LOCK(DBContext().compact_mutex);
+    uint64_t& cursor{DBContext().compact_cursor};
+    auto key_at = [](uint64_t prefix) {
+        std::string key(sizeof(prefix), '\0');
+        WriteBE64(reinterpret_cast<unsigned char*>(key.data()), prefix);
+        return key;
+    };
+    const std::string begin{key_at(cursor)};
+    auto size_until = [&](uint64_t prefix) {
+        const std::string end{key_at(prefix)};
+        return EstimateSizeImpl(MakeByteSpan(begin), MakeByteSpan(end));
+    };
+
+    // Find the end of the range to compact by bisecting over the first 8 bytes of keys.
+    if (cursor == std::numeric_limits<uint64_t>::max() || size_until(std::numeric_limits<uint64_t>::max()) < max_bytes) {
+        const leveldb::Slice begin_slice{begin};
+        DBContext().pdb->CompactRange(&begin_slice, nullptr);
+        cursor = 0;
+        return true;
+    }
+    uint64_t lo{cursor}, hi{std::numeric_limits<uint64_t>::max()};
+    while (hi - lo > 1) {
+        const uint64_t mid{lo + (hi - lo) / 2};
+        (size_until(mid) < max_bytes ? lo : hi) = mid;
+    }
+    const std::string end{key_at(hi)};
+    const leveldb::Slice begin_slice{begin}, end_slice{end};
+    DBContext().pdb->CompactRange(&begin_slice, &end_slice);
+    cursor = hi;
+    return false;
+}
+
+void CDBWrapper::CompactWhenIdle()
+{
+    while (DBContext().compact_interrupt.sleep_for(DB_IDLE_CHECK_INTERVAL)) {
+        while (!DBContext().compact_interrupt && SteadyClock::now() - DBContext().last_write.load() >= DB_IDLE_TIME) {
+            const DBCompactionStats stats{GetCompactionStats()};
+            if (stats.pending_bytes == 0 && (stats.levels.empty() || stats.levels[0].files == 0)) break;
+            LogDebug(BCLog::LEVELDB, "Compacting idle database %s (level 0 files: %d, pending: %d bytes)\n",
+                     m_name, stats.levels.empty() ? 0 : stats.levels[0].files, stats.pending_bytes);
+            if (CompactStep(DB_IDLE_COMPACTION_STEP)) break;
+        }
+    }
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -349,6 +618,55 @@ std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key) const
     return strValue;
 }
 
+std::vector<std::optional<std::string>> CDBWrapper::ReadManyImpl(const std::vector<DataStream>& keys) const
+{
+    std::vector<leveldb::Slice> slices;
+    slices.reserve(keys.size());
+    for (const DataStream& key : keys) {
+        slices.emplace_back(CharCast(key.data()), key.size());
+    }
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return slices[a].compare(slices[b]) < 0; });
+
+    // Let all lookups see the same state of the database, whichever thread issues them.
+    leveldb::ReadOptions options{DBContext().readoptions};
+    options.snapshot = DBContext().pdb->GetSnapshot();
+
+    std::vector<std::optional<std::string>> values(keys.size());
+    const size_t num_checks{(order.size() + READ_MANY_CHUNK_SIZE - 1) / READ_MANY_CHUNK_SIZE};
+    std::vector<leveldb::Status> errors(num_checks);
+    std::vector<ReadManyCheck> checks;
+    checks.reserve(num_checks);
+    for (size_t i = 0; i < num_checks; ++i) {
+        const size_t begin{i * READ_MANY_CHUNK_SIZE};
+        checks.push_back(ReadManyCheck{
+            .db = DBContext().pdb,
+            .options = &options,
+            .keys = &slices,
+            .indices = Span{order}.subspan(begin, std::min(READ_MANY_CHUNK_SIZE, order.size() - begin)),
+            .values = &values,
+            .error = &errors[i]});
+    }
+    bool ok;
+    if (DBContext().read_queue && checks.size() > 1) {
+        CCheckQueueControl<ReadManyCheck> control{DBContext().read_queue.get()};
+        control.Add(std::move(checks));
+        ok = control.Wait();
+    } else {
+        ok = std::all_of(checks.begin(), checks.end(), [](ReadManyCheck& check) { return check(); });
+    }
+    DBContext().pdb->ReleaseSnapshot(options.snapshot);
+    if (!ok) {
+        for (const leveldb::Status& status : errors) {
+            if (status.ok()) continue;
+            LogPrintf("LevelDB read failure: %s\n", status.ToString());
+            HandleError(status);
+        }
+    }
+    return values;
+}
+
 bool CDBWrapper::ExistsImpl(Span<const std::byte> key) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
@@ -395,6 +713,20 @@ CDBIterator* CDBWrapper::NewIterator()
     return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
 }
 
+std::vector<std::unique_ptr<CDBIterator>> CDBWrapper::NewIterators(size_t count)
+{
+    leveldb::ReadOptions options{DBContext().iteroptions};
+    options.snapshot = DBContext().pdb->GetSnapshot();
+    std::vector<std::unique_ptr<CDBIterator>> iterators;
+    iterators.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        iterators.push_back(std::make_unique<CDBIterator>(*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(options))));
+    }
+    // The iterators keep reading the state of the snapshot after it is released.
+    DBContext().pdb->ReleaseSnapshot(options.snapshot);
+    return iterators;
+}
+
 void CDBIterator::SeekImpl(Span<const std::byte> key)
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
@@ -12,7 +12,9 @@
 #include <util/check.h>
 #include <util/fs.h>
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -27,6 +29,38 @@ static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Maximum rate at which table files are written by compactions, in bytes
+    //! per second, or 0 for no limit.
+    uint64_t max_compaction_rate = 0;
+};
+
+//! LevelDB settings suited to how a database is used.
+struct DBTuning {
+    //! Share of the cache size used by the block cache, in percent.
+    int block_cache_percent{50};
+    //! Share of the cache size used by each write buffer, in percent. Up to
+    //! two write buffers may be held in memory simultaneously.
+    int write_buffer_percent{25};
+    //! Compress table blocks with Snappy. Blocks are stored uncompressed if
+    //! LevelDB is built without Snappy support.
+    bool compression{false};
+    //! Bits per key of the bloom filters of table files, or 0 for none.
+    int bloom_bits_per_key{10};
+    //! Size of table files, or 0 for the LevelDB default.
+    size_t max_file_size{0};
+};
+
+//! Tuning for databases with random reads and writes, many of which
+//! overwrite or delete existing keys, such as the UTXO set.
+static constexpr DBTuning DB_TUNING_RANDOM_ACCESS{};
+
+//! Tuning for indexes, to which entries are mostly appended once and rarely
+//! changed: a larger write buffer and larger table files make for fewer
+//! compactions, at the expense of the block cache.
+static constexpr DBTuning DB_TUNING_APPEND_MOSTLY{
+    .block_cache_percent = 30,
+    .write_buffer_percent = 35,
+    .max_file_size = 32 << 20,
 };
 
 //! Application-specific storage settings.
@@ -44,6 +78,34 @@ struct DBParams {
     bool obfuscate = false;
     //! Passed-through options.
     DBOptions options{};
+    //! LevelDB settings suited to how the database is used.
+    DBTuning tuning{DB_TUNING_RANDOM_ACCESS};
+    //! If true, compact the database in the background while it is not
+    //! written to, so that compactions are less likely to slow down writes.
+    bool compact_when_idle = false;
+    //! Number of threads issuing the lookups of ReadMany() along with the
+    //! calling thread, or 0 to issue them from the calling thread only.
+    int read_threads = 0;
+};
+
+//! Statistics about the compactions of a database.
+struct DBCompactionStats {
+    struct Level {
+        int files{0};
+        uint64_t bytes{0};
+        //! Time spent compacting into this level, and data read and written
+        //! doing so, as reported by LevelDB in whole seconds and MiB.
+        std::chrono::seconds compaction_time{0};
+        uint64_t bytes_read{0};
+        uint64_t bytes_written{0};
+    };
+    std::vector<Level> levels;
+    //! Estimate of the data LevelDB has yet to compact for its levels to fit
+    //! their target sizes.
+    uint64_t pending_bytes{0};
+    //! Time spent in writes that LevelDB slowed down or stalled because too
+    //! many files were waiting to be compacted.
+    std::chrono::microseconds stall_time{0};
 };
 
 class dbwrapper_error : public std::runtime_error
@@ -205,7 +267,11 @@ private:
     //! whether or not the database resides in memory
     bool m_is_memory;
 
+    //! Compact the database for as long as it is not written to and compactions are pending.
+    void CompactWhenIdle();
+
     std::optional<std::string> ReadImpl(Span<const std::byte> key) const;
+    std::vector<std::optional<std::string>> ReadManyImpl(const std::vector<DataStream>& keys) const;
     bool ExistsImpl(Span<const std::byte> key) const;
     size_t EstimateSizeImpl(Span<const std::byte> key1, Span<const std::byte> key2) const;
     auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
@@ -237,6 +303,37 @@ public:
         return true;
     }
 
+    /**
+     * Read the values of many keys at once. The lookups are issued in key
+     * order, so that consecutive lookups tend to hit the same table blocks,
+     * and are spread over the read threads of the database, if any. All of
+     * them see the same state of the database.
+     *
+     * @param[in]  keys    The keys to look up.
+     * @param[out] values  The value of each key, in the order of keys, or
+     *                     std::nullopt if it is missing or cannot be deserialized.
+     */
+    template <typename K, typename V>
+    void ReadMany(const std::vector<K>& keys, std::vector<std::optional<V>>& values) const
+    {
+        std::vector<DataStream> ss_keys(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ss_keys[i] << keys[i];
+        }
+        std::vector<std::optional<std::string>> str_values{ReadManyImpl(ss_keys)};
+        values.assign(keys.size(), std::nullopt);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (!str_values[i]) continue;
+            try {
+                DataStream ssValue{MakeByteSpan(*str_values[i])};
+                ssValue.Xor(obfuscate_key);
+                ssValue >> values[i].emplace();
+            } catch (const std::exception&) {
+                values[i].reset();
+            }
+        }
+    }
+
     template <typename K, typename V>
     bool Write(const K& key, const V& value, bool fSync = false)
     {
@@ -275,8 +372,23 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    DBCompactionStats GetCompactionStats() const;
+
+    /**
+     * Compact about max_bytes of the database, starting where the previous
+     * call stopped. Returns true once the end of the database is reached,
+     * after which the next call starts over from the beginning.
+     */
+    bool CompactStep(size_t max_bytes);
+
     CDBIterator* NewIterator();
 
+    /**
+     * Create several iterators that all see the same state of the database,
+     * e.g. to iterate over separate key ranges in parallel.
+     */
+    std::vector<std::unique_ptr<CDBIterator>> NewIterators(size_t count);
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
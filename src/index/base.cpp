@@ -19,13 +19,24 @@
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Blocks read ahead per worker thread during the initial sync
+constexpr size_t SYNC_BLOCKS_AHEAD_PER_WORKER{4};
+//! Upper bound on the blocks held in memory ahead of the sync thread
+constexpr size_t SYNC_MAX_BLOCKS_AHEAD{32};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -43,14 +54,15 @@ CBlockLocator GetLocator(interfaces::Chain& chain, const uint256& block_hash)
     return locator;
 }
 
-BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool f_wipe, bool f_obfuscate) :
+BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool f_wipe, bool f_obfuscate, const DBTuning& tuning) :
     CDBWrapper{DBParams{
         .path = path,
         .cache_bytes = n_cache_size,
         .memory_only = f_memory,
         .wipe_data = f_wipe,
         .obfuscate = f_obfuscate,
-        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }()}}
+        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }(),
+        .tuning = tuning}}
 {}
 
 bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
@@ -141,12 +153,113 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
-void BaseIndex::Sync()
+namespace {
+/** A block read from disk, and prepared, ahead of being appended to the index. */
+struct SyncBlock {
+    const CBlockIndex* const pindex;
+    CBlock block;
+    std::any prepared;
+    bool ok{false};
+    //! Set by the worker thread once the fields above are final, guarded by SyncBlockReader::m_mutex
+    bool done{false};
+
+    explicit SyncBlock(const CBlockIndex* pindex) : pindex{pindex} {}
+};
+
+/**
+ * Pool of threads processing the blocks handed to it by the index sync thread,
+ * in the order they were added. Without threads, blocks are processed by the
+ * caller of Add().
+ */
+class SyncBlockReader
+{
+    Mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    std::deque<std::shared_ptr<SyncBlock>> m_queue GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    const std::function<void(SyncBlock&)> m_process;
+    std::vector<std::thread> m_threads;
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::shared_ptr<SyncBlock> item;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+                if (m_stop) return;
+                item = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            m_process(*item);
+            WITH_LOCK(m_mutex, item->done = true);
+            m_done_cv.notify_all();
+        }
+    }
+
+public:
+    SyncBlockReader(int workers, std::function<void(SyncBlock&)> process)
+        : m_process{std::move(process)}
+    {
+        for (int i = 0; i < workers; ++i) {
+            m_threads.emplace_back(&util::TraceThread, strprintf("idxsync.%i", i), [this] { Loop(); });
+        }
+    }
+
+    ~SyncBlockReader() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_work_cv.notify_all();
+        for (std::thread& thread : m_threads) thread.join();
+    }
+
+    void Add(std::shared_ptr<SyncBlock> item) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_threads.empty()) {
+            m_process(*item);
+            WITH_LOCK(m_mutex, item->done = true);
+            return;
+        }
+        WITH_LOCK(m_mutex, m_queue.push_back(std::move(item)));
+        m_work_cv.notify_one();
+    }
+
+    void Wait(const SyncBlock& item) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return item.done; });
+    }
+};
+} // namespace
+
+bool BaseIndex::ReadSyncBlock(const CBlockIndex& pindex, CBlock& block, std::any& prepared)
+{
+    if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, pindex)) {
+        return false;
+    }
+    interfaces::BlockInfo block_info = kernel::MakeBlockInfo(&pindex, &block);
+    if (!CustomPrepare(block_info, prepared)) {
+        LogError("%s: Failed to prepare block %s for %s\n", __func__, pindex.GetBlockHash().ToString(), GetName());
+        return false;
+    }
+    return true;
+}
+
+void BaseIndex::Sync(int workers)
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
+
+        // Blocks following pindex that are being read by the reader, in chain order.
+        std::deque<std::shared_ptr<SyncBlock>> blocks_ahead;
+        const size_t max_blocks_ahead{workers > 0 ? std::min(size_t(workers) * SYNC_BLOCKS_AHEAD_PER_WORKER, SYNC_MAX_BLOCKS_AHEAD) : 1};
+        SyncBlockReader reader{workers, [this](SyncBlock& item) {
+            item.ok = ReadSyncBlock(*item.pindex, item.block, item.prepared);
+        }};
+
         while (true) {
             if (m_interrupt) {
                 LogPrintf("%s: m_interrupt set; exiting ThreadSync\n", GetName());
@@ -159,10 +272,25 @@ void BaseIndex::Sync()
                 return;
             }
 
-            const CBlockIndex* pindex_next = WITH_LOCK(cs_main, return NextSyncBlock(pindex, m_chainstate->m_chain));
-            // If pindex_next is null, it means pindex is the chain tip, so
+            // Read ahead along the current chain. Stop at a fork, so the
+            // index is rewound only once the blocks before it are appended.
+            std::vector<std::shared_ptr<SyncBlock>> new_blocks;
+            {
+                LOCK(cs_main);
+                const CBlockIndex* last{blocks_ahead.empty() ? pindex : blocks_ahead.back()->pindex};
+                while (blocks_ahead.size() < max_blocks_ahead) {
+                    const CBlockIndex* next{NextSyncBlock(last, m_chainstate->m_chain)};
+                    if (!next || (!blocks_ahead.empty() && next->pprev != last)) break;
+                    blocks_ahead.push_back(std::make_shared<SyncBlock>(next));
+                    new_blocks.push_back(blocks_ahead.back());
+                    last = next;
+                }
+            }
+            for (auto& item : new_blocks) reader.Add(std::move(item));
+
+            // If there is no next block, it means pindex is the chain tip, so
             // commit data indexed so far.
-            if (!pindex_next) {
+            if (blocks_ahead.empty()) {
                 SetBestBlockIndex(pindex);
                 // No need to handle errors in Commit. See rationale above.
                 Commit();
@@ -173,29 +301,30 @@ void BaseIndex::Sync()
                 // attached while m_synced is still false, and it would not be
                 // indexed.
                 LOCK(::cs_main);
-                pindex_next = NextSyncBlock(pindex, m_chainstate->m_chain);
-                if (!pindex_next) {
+                if (!NextSyncBlock(pindex, m_chainstate->m_chain)) {
                     m_synced = true;
                     break;
                 }
+                continue;
             }
+
+            const std::shared_ptr<SyncBlock> item{std::move(blocks_ahead.front())};
+            blocks_ahead.pop_front();
+            const CBlockIndex* pindex_next{item->pindex};
             if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
                 FatalErrorf("%s: Failed to rewind index %s to a previous chain tip", __func__, GetName());
                 return;
             }
             pindex = pindex_next;
 
-
-            CBlock block;
-            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *pindex)) {
+            reader.Wait(*item);
+            if (!item->ok) {
                 FatalErrorf("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
-            } else {
-                block_info.data = &block;
             }
-            if (!CustomAppend(block_info)) {
+            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, &item->block);
+            if (!CustomAppendPrepared(block_info, item->prepared)) {
                 FatalErrorf("%s: Failed to write block %s to index database",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
@@ -399,11 +528,11 @@ void BaseIndex::Interrupt()
     m_interrupt();
 }
 
-bool BaseIndex::StartBackgroundSync()
+bool BaseIndex::StartBackgroundSync(int workers)
 {
     if (!m_init) throw std::logic_error("Error: Cannot start a non-initialized index");
 
-    m_thread_sync = std::thread(&util::TraceThread, GetName(), [this] { Sync(); });
+    m_thread_sync = std::thread(&util::TraceThread, GetName(), [this, workers] { Sync(workers); });
     return true;
 }
 
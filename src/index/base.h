@@ -11,6 +11,7 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <string>
 
 class CBlock;
@@ -21,6 +22,11 @@ namespace interfaces {
 class Chain;
 } // namespace interfaces
 
+/** Default for -indexworkers, threads per index reading blocks ahead during the initial sync */
+static constexpr int DEFAULT_INDEX_WORKERS{0};
+/** Maximum number of -indexworkers */
+static constexpr int MAX_INDEX_WORKERS{16};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -52,7 +58,8 @@ protected:
     {
     public:
         DB(const fs::path& path, size_t n_cache_size,
-           bool f_memory = false, bool f_wipe = false, bool f_obfuscate = false);
+           bool f_memory = false, bool f_wipe = false, bool f_obfuscate = false,
+           const DBTuning& tuning = DB_TUNING_APPEND_MOSTLY);
 
         /// Read block locator of the chain that the index is in sync with.
         bool ReadBestBlock(CBlockLocator& locator) const;
@@ -92,6 +99,10 @@ private:
     /// Loop over disconnected blocks and call CustomRewind.
     bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip);
 
+    /// Read a block from disk and call CustomPrepare on it. May be called from
+    /// several threads at once during the initial sync.
+    bool ReadSyncBlock(const CBlockIndex& pindex, CBlock& block, std::any& prepared);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -112,6 +123,16 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Compute the part of the index entries for a block that does not depend
+    /// on previously indexed blocks. During the initial sync this is called
+    /// ahead of CustomAppendPrepared, possibly on several threads at once and
+    /// out of order, so it must not modify index state.
+    [[nodiscard]] virtual bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) { return true; }
+
+    /// Write index entries for a block using the result of CustomPrepare.
+    /// Blocks are appended in chain order, as with CustomAppend.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -147,14 +168,17 @@ public:
     [[nodiscard]] bool Init();
 
     /// Starts the initial sync process on a background thread.
-    [[nodiscard]] bool StartBackgroundSync();
+    [[nodiscard]] bool StartBackgroundSync(int workers = DEFAULT_INDEX_WORKERS);
 
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
     /// flag is set and the BlockConnected ValidationInterface callback takes
     /// over and the sync thread exits.
-    void Sync();
+    ///
+    /// With workers > 0, blocks are read from disk and passed to CustomPrepare
+    /// on that many additional threads, ahead of being appended in order.
+    void Sync(int workers = DEFAULT_INDEX_WORKERS);
 
     /// Stops the instance from staying in sync with blockchain updates.
     void Stop();
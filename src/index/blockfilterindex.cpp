@@ -11,6 +11,7 @@
 #include <index/blockfilterindex.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <streams.h>
 #include <undo.h>
 #include <util/fs_helpers.h>
 #include <validation.h>
@@ -43,6 +44,8 @@ constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000; // 1 MiB
  *  is big enough for a 2,000,000 length block chain, which
  *  we should be enough until ~2047. */
 constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
+/** Maximum number of bytes read from a filter file at once when reading a range of filters */
+constexpr unsigned int MAX_FILTER_READ_SIZE{0x400000}; // 4 MiB
 
 namespace {
 
@@ -101,6 +104,7 @@ BlockFilterIndex::BlockFilterIndex(std::unique_ptr<interfaces::Chain> chain, Blo
                                    size_t n_cache_size, bool f_memory, bool f_wipe)
     : BaseIndex(std::move(chain), BlockFilterTypeName(filter_type) + " block filter index")
     , m_filter_type(filter_type)
+    , m_filter_cache(n_cache_size / 2)
 {
     const std::string& filter_name = BlockFilterTypeName(filter_type);
     if (filter_name.empty()) throw std::invalid_argument("unknown filter_type");
@@ -108,7 +112,7 @@ BlockFilterIndex::BlockFilterIndex(std::unique_ptr<interfaces::Chain> chain, Blo
     fs::path path = gArgs.GetDataDirNet() / "indexes" / "blockfilter" / fs::u8path(filter_name);
     fs::create_directories(path);
 
-    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size / 2, f_memory, f_wipe);
     m_filter_fileseq = std::make_unique<FlatFileSeq>(std::move(path), "fltr", FLTR_FILE_CHUNK_SIZE);
 }
 
@@ -160,29 +164,96 @@ bool BlockFilterIndex::CustomCommit(CDBBatch& batch)
     return true;
 }
 
-bool BlockFilterIndex::ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const
+/** Read a filter written by WriteFilterToDisk and check it against the hash stored in the db. */
+template <typename Stream>
+static bool ReadFilter(Stream& s, const uint256& hash, uint256& block_hash, std::vector<uint8_t>& encoded_filter)
 {
-    AutoFile filein{m_filter_fileseq->Open(pos, true)};
-    if (filein.IsNull()) {
+    try {
+        s >> block_hash >> encoded_filter;
+    } catch (const std::exception& e) {
+        LogError("%s: Failed to deserialize block filter from disk: %s\n", __func__, e.what());
+        return false;
+    }
+    if (Hash(encoded_filter) != hash) {
+        LogError("Checksum mismatch in filter decode.\n");
         return false;
     }
+    return true;
+}
 
-    // Check that the hash of the encoded_filter matches the one stored in the db.
-    uint256 block_hash;
-    std::vector<uint8_t> encoded_filter;
-    try {
-        filein >> block_hash >> encoded_filter;
-        if (Hash(encoded_filter) != hash) {
-            LogError("Checksum mismatch in filter decode.\n");
-            return false;
+bool BlockFilterIndex::ReadFiltersFromDisk(const std::vector<FilterLocation>& locations,
+                                           std::vector<EncodedBlockFilter>& filters_out) const
+{
+    filters_out.assign(locations.size(), EncodedBlockFilter{});
+
+    std::vector<size_t> missing;
+    {
+        LOCK(m_filter_cache_mutex);
+        for (size_t i = 0; i < locations.size(); ++i) {
+            const auto cached{m_filter_cache.Get(locations[i].block_hash)};
+            if (cached && cached->filter_hash == locations[i].filter_hash) {
+                filters_out[i] = {m_filter_type, locations[i].block_hash, cached->encoded_filter};
+            } else {
+                missing.push_back(i);
+            }
         }
-        filter = BlockFilter(GetFilterType(), block_hash, std::move(encoded_filter), /*skip_decode_check=*/true);
     }
-    catch (const std::exception& e) {
-        LogError("%s: Failed to deserialize block filter from disk: %s\n", __func__, e.what());
-        return false;
+
+    for (size_t run_begin = 0; run_begin < missing.size();) {
+        // Filters of consecutive blocks are usually stored one after another in the same file, so
+        // read a run of them at once, up to MAX_FILTER_READ_SIZE bytes before the last one.
+        const FlatFilePos& first_pos{locations[missing[run_begin]].pos};
+        size_t run_end{run_begin + 1};
+        while (run_end < missing.size()) {
+            const FlatFilePos& prev_pos{locations[missing[run_end - 1]].pos};
+            const FlatFilePos& next_pos{locations[missing[run_end]].pos};
+            if (next_pos.nFile != first_pos.nFile || next_pos.nPos <= prev_pos.nPos ||
+                next_pos.nPos - first_pos.nPos > MAX_FILTER_READ_SIZE) {
+                break;
+            }
+            ++run_end;
+        }
+
+        AutoFile filein{m_filter_fileseq->Open(first_pos, true)};
+        if (filein.IsNull()) {
+            return false;
+        }
+
+        // All filters but the last one of the run are parsed from the buffer, the last one is read
+        // from the file directly, as its size is not known in advance.
+        std::vector<uint8_t> buffer;
+        const FlatFilePos& last_pos{locations[missing[run_end - 1]].pos};
+        try {
+            buffer.resize(last_pos.nPos - first_pos.nPos);
+            filein.read(MakeWritableByteSpan(buffer));
+        } catch (const std::exception& e) {
+            LogError("%s: Failed to read block filters from disk: %s\n", __func__, e.what());
+            return false;
+        }
+
+        for (size_t j = run_begin; j < run_end; ++j) {
+            const FilterLocation& location{locations[missing[j]]};
+            uint256 block_hash;
+            std::vector<uint8_t> encoded_filter;
+            if (j + 1 < run_end) {
+                const size_t offset{location.pos.nPos - first_pos.nPos};
+                const size_t size{locations[missing[j + 1]].pos.nPos - location.pos.nPos};
+                SpanReader reader{Span{buffer}.subspan(offset, size)};
+                if (!ReadFilter(reader, location.filter_hash, block_hash, encoded_filter)) return false;
+            } else {
+                if (!ReadFilter(filein, location.filter_hash, block_hash, encoded_filter)) return false;
+            }
+            filters_out[missing[j]] = {m_filter_type, block_hash,
+                                       std::make_shared<const std::vector<uint8_t>>(std::move(encoded_filter))};
+        }
+        run_begin = run_end;
     }
 
+    LOCK(m_filter_cache_mutex);
+    for (const size_t i : missing) {
+        const auto& encoded_filter{filters_out[i].encoded_filter};
+        m_filter_cache.Put(locations[i].block_hash, CachedFilter{locations[i].filter_hash, encoded_filter}, encoded_filter->size());
+    }
     return true;
 }
 
@@ -249,6 +320,12 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
 }
 
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, prepared);
+}
+
+bool BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared)
 {
     CBlockUndo block_undo;
 
@@ -261,7 +338,13 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
         }
     }
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    prepared = BlockFilter(m_filter_type, *Assert(block.data), block_undo);
+    return true;
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    const BlockFilter& filter{std::any_cast<const BlockFilter&>(prepared)};
 
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
@@ -357,8 +440,9 @@ static bool LookupOne(const CDBWrapper& db, const CBlockIndex* block_index, DBVa
     return db.Read(DBHashKey(block_index->GetBlockHash()), result);
 }
 
+/** Look up the entries of a range of blocks, along with their block hashes. */
 static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start_height,
-                        const CBlockIndex* stop_index, std::vector<DBVal>& results)
+                        const CBlockIndex* stop_index, std::vector<std::pair<uint256, DBVal>>& results)
 {
     if (start_height < 0) {
         LogError("%s: start height (%d) is negative\n", __func__, start_height);
@@ -401,12 +485,13 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
         uint256 block_hash = block_index->GetBlockHash();
 
         size_t i = static_cast<size_t>(block_index->nHeight - start_height);
+        results[i].first = block_hash;
         if (block_hash == values[i].first) {
-            results[i] = std::move(values[i].second);
+            results[i].second = std::move(values[i].second);
             continue;
         }
 
-        if (!db.Read(DBHashKey(block_hash), results[i])) {
+        if (!db.Read(DBHashKey(block_hash), results[i].second)) {
             LogError("%s: unable to read value in %s at key (%c, %s)\n",
                          __func__, index_name, DB_BLOCK_HASH, block_hash.ToString());
             return false;
@@ -416,14 +501,30 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
     return true;
 }
 
-bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
+bool BlockFilterIndex::LookupEncodedFilter(const CBlockIndex* block_index, EncodedBlockFilter& filter_out) const
 {
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
     }
 
-    return ReadFilterFromDisk(entry.pos, entry.hash, filter_out);
+    std::vector<EncodedBlockFilter> filters;
+    if (!ReadFiltersFromDisk({{block_index->GetBlockHash(), entry.hash, entry.pos}}, filters)) {
+        return false;
+    }
+    filter_out = std::move(filters.front());
+    return true;
+}
+
+bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
+{
+    EncodedBlockFilter filter;
+    if (!LookupEncodedFilter(block_index, filter)) {
+        return false;
+    }
+
+    filter_out = BlockFilter(filter.filter_type, filter.block_hash, *filter.encoded_filter, /*skip_decode_check=*/true);
+    return true;
 }
 
 bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out)
@@ -456,23 +557,35 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint25
     return true;
 }
 
-bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* stop_index,
-                                         std::vector<BlockFilter>& filters_out) const
+bool BlockFilterIndex::LookupEncodedFilterRange(int start_height, const CBlockIndex* stop_index,
+                                                std::vector<EncodedBlockFilter>& filters_out) const
 {
-    std::vector<DBVal> entries;
+    std::vector<std::pair<uint256, DBVal>> entries;
     if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
     }
 
-    filters_out.resize(entries.size());
-    auto filter_pos_it = filters_out.begin();
-    for (const auto& entry : entries) {
-        if (!ReadFilterFromDisk(entry.pos, entry.hash, *filter_pos_it)) {
-            return false;
-        }
-        ++filter_pos_it;
+    std::vector<FilterLocation> locations;
+    locations.reserve(entries.size());
+    for (const auto& [block_hash, entry] : entries) {
+        locations.push_back({block_hash, entry.hash, entry.pos});
     }
+    return ReadFiltersFromDisk(locations, filters_out);
+}
 
+bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* stop_index,
+                                         std::vector<BlockFilter>& filters_out) const
+{
+    std::vector<EncodedBlockFilter> filters;
+    if (!LookupEncodedFilterRange(start_height, stop_index, filters)) {
+        return false;
+    }
+
+    filters_out.clear();
+    filters_out.reserve(filters.size());
+    for (const auto& filter : filters) {
+        filters_out.emplace_back(filter.filter_type, filter.block_hash, *filter.encoded_filter, /*skip_decode_check=*/true);
+    }
     return true;
 }
 
@@ -480,14 +593,14 @@ bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex
                                              std::vector<uint256>& hashes_out) const
 
 {
-    std::vector<DBVal> entries;
+    std::vector<std::pair<uint256, DBVal>> entries;
     if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
     }
 
     hashes_out.clear();
     hashes_out.reserve(entries.size());
-    for (const auto& entry : entries) {
+    for (const auto& [block_hash, entry] : entries) {
         hashes_out.push_back(entry.hash);
     }
     return true;
@@ -10,15 +10,37 @@
 #include <chain.h>
 #include <flatfile.h>
 #include <index/base.h>
+#include <sync.h>
 #include <util/hasher.h>
+#include <util/lru_cache.h>
 
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
+/**
+ * A block filter as stored by the index, without its decoded element set. Serializes like
+ * BlockFilter, i.e. as the payload of a BIP 157 cfilter message, so that filters can be served
+ * without being decoded or copied.
+ */
+struct EncodedBlockFilter {
+    BlockFilterType filter_type{BlockFilterType::INVALID};
+    uint256 block_hash;
+    std::shared_ptr<const std::vector<unsigned char>> encoded_filter;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << static_cast<uint8_t>(filter_type) << block_hash << *encoded_filter;
+    }
+};
+
 /**
  * BlockFilterIndex is used to store and retrieve block filters, hashes, and headers for a range of
  * blocks by height. An index is constructed for each supported filter type with its own database
@@ -35,7 +57,29 @@ private:
     FlatFilePos m_next_filter_pos;
     std::unique_ptr<FlatFileSeq> m_filter_fileseq;
 
-    bool ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const;
+    /** Disk location of a filter and the hash it is checked against when read. */
+    struct FilterLocation {
+        uint256 block_hash;
+        uint256 filter_hash;
+        FlatFilePos pos;
+    };
+
+    /** Encoded filter held by the filter cache. */
+    struct CachedFilter {
+        uint256 filter_hash;
+        std::shared_ptr<const std::vector<unsigned char>> encoded_filter;
+    };
+
+    mutable Mutex m_filter_cache_mutex;
+    /** Cache of recently read filters by block hash, bounded by their total encoded size. */
+    mutable LRUCache<uint256, CachedFilter, FilterHeaderHasher> m_filter_cache GUARDED_BY(m_filter_cache_mutex);
+
+    /**
+     * Read filters from the cache or disk. Filters stored next to each other in the same file are
+     * read with a single read.
+     */
+    bool ReadFiltersFromDisk(const std::vector<FilterLocation>& locations,
+                             std::vector<EncodedBlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_filter_cache_mutex);
     size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter);
 
     Mutex m_cs_headers_cache;
@@ -58,26 +102,40 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared) override;
+
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
 
 public:
-    /** Constructs the index, which becomes available to be queried. */
+    /**
+     * Constructs the index, which becomes available to be queried. n_cache_size is split evenly
+     * between the database cache and a cache of recently served filters.
+     */
     explicit BlockFilterIndex(std::unique_ptr<interfaces::Chain> chain, BlockFilterType filter_type,
                               size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
     BlockFilterType GetFilterType() const { return m_filter_type; }
 
     /** Get a single filter by block. */
-    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const;
+    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_filter_cache_mutex);
+
+    /** Get a single encoded filter by block. */
+    bool LookupEncodedFilter(const CBlockIndex* block_index, EncodedBlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_filter_cache_mutex);
 
     /** Get a single filter header by block. */
     bool LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a range of filters between two heights on a chain. */
     bool LookupFilterRange(int start_height, const CBlockIndex* stop_index,
-                           std::vector<BlockFilter>& filters_out) const;
+                           std::vector<BlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_filter_cache_mutex);
+
+    /** Get a range of encoded filters between two heights on a chain. */
+    bool LookupEncodedFilterRange(int start_height, const CBlockIndex* stop_index,
+                                  std::vector<EncodedBlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_filter_cache_mutex);
 
     /** Get a range of filter hashes between two heights on a chain. */
     bool LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
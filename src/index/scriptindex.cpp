@@ -0,0 +1,258 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <compressor.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <algorithm>
+
+/* The index database stores one entry per output funding a script and per
+ * input spending from one.
+ *
+ * Keys have the type [DB_SCRIPT, ScriptIndexHash, ScriptHistoryPosition],
+ * 22 bytes in total, so that the history of a script is a contiguous range
+ * of keys sorted by position in the chain.
+ * Values are the funding transaction id and the compressed amount for outputs,
+ * and the spending transaction id, the spent outpoint and the compressed amount
+ * for inputs.
+ */
+constexpr uint8_t DB_SCRIPT{'S'};
+
+namespace {
+
+struct DBKey {
+    ScriptIndexHash script_hash{};
+    ScriptHistoryPosition pos;
+
+    DBKey() = default;
+    DBKey(const ScriptIndexHash& script_hash_in, const ScriptHistoryPosition& pos_in) : script_hash{script_hash_in}, pos{pos_in} {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT);
+        s << script_hash << pos;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPT) {
+            throw std::ios_base::failure("Invalid format for scriptindex DB key");
+        }
+        s >> script_hash >> pos;
+    }
+};
+
+struct DBFundingVal {
+    Txid txid;
+    CAmount amount;
+
+    SERIALIZE_METHODS(DBFundingVal, obj) { READWRITE(obj.txid, Using<AmountCompression>(obj.amount)); }
+};
+
+struct DBSpendingVal {
+    Txid txid;
+    COutPoint prevout;
+    CAmount amount;
+
+    SERIALIZE_METHODS(DBSpendingVal, obj) { READWRITE(obj.txid, obj.prevout, Using<AmountCompression>(obj.amount)); }
+};
+
+/** Index entries of a block, as computed by CustomPrepare */
+using BlockEntries = std::vector<std::pair<ScriptIndexHash, ScriptHistoryEntry>>;
+
+BlockEntries GetBlockEntries(const CBlock& block, const CBlockUndo& block_undo, uint32_t height)
+{
+    BlockEntries entries;
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        const CTransaction& tx{*block.vtx[tx_pos]};
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CTxOut& out{tx.vout[n]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            ScriptHistoryEntry& entry{entries.emplace_back(ComputeScriptIndexHash(out.scriptPubKey), ScriptHistoryEntry{}).second};
+            entry.pos = {height, tx_pos, /*spending=*/false, n};
+            entry.txid = tx.GetHash();
+            entry.amount = out.nValue;
+        }
+        // The coinbase tx has no undo data since no former output is spent
+        if (tx.IsCoinBase()) continue;
+        const CTxUndo& tx_undo{block_undo.vtxundo.at(tx_pos - 1)};
+        for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+            const CTxOut& spent{tx_undo.vprevout.at(n).out};
+            ScriptHistoryEntry& entry{entries.emplace_back(ComputeScriptIndexHash(spent.scriptPubKey), ScriptHistoryEntry{}).second};
+            entry.pos = {height, tx_pos, /*spending=*/true, n};
+            entry.txid = tx.GetHash();
+            entry.prevout = tx.vin[n].prevout;
+            entry.amount = spent.nValue;
+        }
+    }
+    return entries;
+}
+
+} // namespace
+
+ScriptIndexHash ComputeScriptIndexHash(const CScript& script)
+{
+    unsigned char hash[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(script.data(), script.size()).Finalize(hash);
+    ScriptIndexHash ret;
+    std::copy_n(hash, ret.size(), ret.begin());
+    return ret;
+}
+
+std::unique_ptr<ScriptIndex> g_script_index;
+
+/** Access to the scriptindex database (indexes/scriptindex/) */
+class ScriptIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the entries of a block to the DB.
+    [[nodiscard]] bool WriteEntries(const BlockEntries& entries);
+};
+
+ScriptIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "scriptindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool ScriptIndex::DB::WriteEntries(const BlockEntries& entries)
+{
+    CDBBatch batch(*this);
+    for (const auto& [script_hash, entry] : entries) {
+        if (entry.pos.spending) {
+            batch.Write(DBKey{script_hash, entry.pos}, DBSpendingVal{entry.txid, entry.prevout, entry.amount});
+        } else {
+            batch.Write(DBKey{script_hash, entry.pos}, DBFundingVal{entry.txid, entry.amount});
+        }
+    }
+    return WriteBatch(batch);
+}
+
+ScriptIndex::ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptindex"), m_db(std::make_unique<ScriptIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+ScriptIndex::~ScriptIndex() = default;
+
+BaseIndex::DB& ScriptIndex::GetDB() const { return *m_db; }
+
+bool ScriptIndex::ReadBlockWithUndo(const CBlockIndex& block_index, CBlock& block, CBlockUndo& block_undo) const
+{
+    if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, block_index)) {
+        LogError("%s: Failed to read block %s from disk\n", __func__, block_index.GetBlockHash().ToString());
+        return false;
+    }
+    if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, block_index)) {
+        LogError("%s: Failed to read undo data of block %s from disk\n", __func__, block_index.GetBlockHash().ToString());
+        return false;
+    }
+    return true;
+}
+
+bool ScriptIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, prepared);
+}
+
+bool ScriptIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    // pindex variable gives indexing code access to node internals. It
+    // will be removed in upcoming commit
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+    CBlockUndo block_undo;
+    if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
+        return false;
+    }
+    prepared = GetBlockEntries(*Assert(block.data), block_undo, block.height);
+    return true;
+}
+
+bool ScriptIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    if (block.height == 0) return true;
+    return m_db->WriteEntries(std::any_cast<const BlockEntries&>(prepared));
+}
+
+bool ScriptIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    const CBlockIndex* iter_tip;
+    const CBlockIndex* new_tip_index;
+    {
+        LOCK(cs_main);
+        iter_tip = m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash);
+        new_tip_index = m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash);
+    }
+
+    // Erase the entries of the disconnected blocks, which are found again from
+    // their block and undo data.
+    CDBBatch batch(*m_db);
+    for (; iter_tip != new_tip_index; iter_tip = iter_tip->pprev) {
+        CBlock block;
+        CBlockUndo block_undo;
+        if (!ReadBlockWithUndo(*iter_tip, block, block_undo)) {
+            return false;
+        }
+        for (const auto& [script_hash, entry] : GetBlockEntries(block, block_undo, iter_tip->nHeight)) {
+            batch.Erase(DBKey{script_hash, entry.pos});
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool ScriptIndex::LookupHistory(const CScript& script, const std::optional<ScriptHistoryPosition>& after, size_t max_count,
+                                std::vector<ScriptHistoryEntry>& entries) const
+{
+    const ScriptIndexHash script_hash{ComputeScriptIndexHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(DBKey{script_hash, after.value_or(ScriptHistoryPosition{})});
+
+    entries.clear();
+    DBKey key;
+    while (entries.size() < max_count && db_it->Valid() && db_it->GetKey(key) && key.script_hash == script_hash) {
+        if (after && key.pos <= *after) {
+            db_it->Next();
+            continue;
+        }
+        ScriptHistoryEntry& entry{entries.emplace_back()};
+        entry.pos = key.pos;
+        if (key.pos.spending) {
+            DBSpendingVal value;
+            if (!db_it->GetValue(value)) {
+                LogError("%s: unable to read value in %s\n", __func__, GetName());
+                return false;
+            }
+            entry.txid = value.txid;
+            entry.prevout = value.prevout;
+            entry.amount = value.amount;
+        } else {
+            DBFundingVal value;
+            if (!db_it->GetValue(value)) {
+                LogError("%s: unable to read value in %s\n", __func__, GetName());
+                return false;
+            }
+            entry.txid = value.txid;
+            entry.amount = value.amount;
+        }
+        db_it->Next();
+    }
+    return true;
+}
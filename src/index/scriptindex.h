@@ -0,0 +1,126 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTINDEX_H
+#define BITCOIN_INDEX_SCRIPTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class CBlockUndo;
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTINDEX{false};
+
+/** Compact hash identifying a scriptPubKey in the script index: the first
+ * bytes of its SHA256, i.e. of the Electrum protocol's script hash. */
+using ScriptIndexHash = std::array<uint8_t, 8>;
+
+ScriptIndexHash ComputeScriptIndexHash(const CScript& script);
+
+/** Position of an entry in the history of a script. History is sorted by
+ * position, so it can be used to resume a lookup after the last entry seen. */
+struct ScriptHistoryPosition {
+    uint32_t height{0};
+    /** Position of the transaction in the block */
+    uint32_t tx_pos{0};
+    /** Whether the entry is an input spending from the script, rather than an output funding it */
+    bool spending{false};
+    /** Index of the output or input in the transaction */
+    uint32_t index{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        // Big-endian, so that database keys sort by position
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_pos);
+        ser_writedata8(s, spending);
+        ser_writedata32be(s, index);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        height = ser_readdata32be(s);
+        tx_pos = ser_readdata32be(s);
+        spending = ser_readdata8(s);
+        index = ser_readdata32be(s);
+    }
+
+    friend auto operator<=>(const ScriptHistoryPosition&, const ScriptHistoryPosition&) = default;
+};
+
+/** A transaction output funding a script, or a transaction input spending from it. */
+struct ScriptHistoryEntry {
+    ScriptHistoryPosition pos;
+    /** The funding or spending transaction */
+    Txid txid;
+    /** The outpoint spent, for spending entries */
+    COutPoint prevout;
+    CAmount amount{0};
+};
+
+/**
+ * ScriptIndex maps scriptPubKeys to the outputs funding them and the inputs
+ * spending from them, ordered by their position in the chain.
+ *
+ * Scripts are only identified by their ScriptIndexHash, so the history of a
+ * script may in theory include entries of a different script with a colliding
+ * hash.
+ */
+class ScriptIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+    bool ReadBlockWithUndo(const CBlockIndex& block_index, CBlock& block, CBlockUndo& block_undo) const;
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~ScriptIndex() override;
+
+    /// Look up the history of a script.
+    ///
+    /// @param[in]   script     The scriptPubKey to look up.
+    /// @param[in]   after      Only return entries after this position, to continue a previous lookup.
+    /// @param[in]   max_count  The maximum number of entries to return.
+    /// @param[out]  entries    The entries found, in chain order.
+    /// @return  false if the index could not be read, true otherwise.
+    bool LookupHistory(const CScript& script, const std::optional<ScriptHistoryPosition>& after, size_t max_count,
+                       std::vector<ScriptHistoryEntry>& entries) const;
+};
+
+/// The global script index. May be null.
+extern std::unique_ptr<ScriptIndex> g_script_index;
+
+#endif // BITCOIN_INDEX_SCRIPTINDEX_H
@@ -11,8 +11,19 @@
 #include <node/blockstorage.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <tuple>
+
 constexpr uint8_t DB_TXINDEX{'t'};
 
+/** Transaction positions compress well, as positions in the same block file share most bytes. */
+static constexpr DBTuning TXINDEX_DB_TUNING{
+    .block_cache_percent = DB_TUNING_APPEND_MOSTLY.block_cache_percent,
+    .write_buffer_percent = DB_TUNING_APPEND_MOSTLY.write_buffer_percent,
+    .compression = true,
+    .max_file_size = DB_TUNING_APPEND_MOSTLY.max_file_size,
+};
+
 std::unique_ptr<TxIndex> g_txindex;
 
 
@@ -31,7 +42,7 @@ public:
 };
 
 TxIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
-    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txindex", n_cache_size, f_memory, f_wipe)
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txindex", n_cache_size, f_memory, f_wipe, /*f_obfuscate=*/false, TXINDEX_DB_TUNING)
 {}
 
 bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
@@ -49,12 +60,19 @@ bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_
 }
 
 TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
-    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe))
+    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size / 2, f_memory, f_wipe)),
+      m_tx_cache(n_cache_size / 2)
 {}
 
 TxIndex::~TxIndex() = default;
 
 bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, prepared);
+}
+
+bool TxIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared)
 {
     // Exclude genesis block transaction because outputs are not spendable.
     if (block.height == 0) return true;
@@ -67,36 +85,84 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    prepared = std::move(vPos);
+    return true;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    if (block.height == 0) return true;
+    const auto& v_pos{std::any_cast<const std::vector<std::pair<uint256, CDiskTxPos>>&>(prepared)};
+    if (!m_db->WriteTxs(v_pos)) return false;
+
+    // Transactions of the block may have been looked up in a block that was disconnected.
+    LOCK(m_tx_cache_mutex);
+    ++m_tx_cache_epoch;
+    for (const auto& [txid, pos] : v_pos) {
+        m_tx_cache.Erase(txid);
+    }
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
 bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
 {
-    CDiskTxPos postx;
-    if (!m_db->ReadTxPos(tx_hash, postx)) {
-        return false;
+    std::vector<std::pair<uint256, CTransactionRef>> txs;
+    FindTxs({&tx_hash, 1}, txs);
+    if (!txs.front().second) return false;
+    std::tie(block_hash, tx) = std::move(txs.front());
+    return true;
+}
+
+void TxIndex::FindTxs(Span<const uint256> tx_hashes, std::vector<std::pair<uint256, CTransactionRef>>& txs_out) const
+{
+    txs_out.assign(tx_hashes.size(), {});
+
+    std::vector<size_t> missing;
+    uint64_t epoch;
+    {
+        LOCK(m_tx_cache_mutex);
+        epoch = m_tx_cache_epoch;
+        for (size_t i = 0; i < tx_hashes.size(); ++i) {
+            if (const auto cached{m_tx_cache.Get(tx_hashes[i])}) {
+                txs_out[i] = {cached->block_hash, cached->tx};
+            } else {
+                missing.push_back(i);
+            }
+        }
     }
 
-    AutoFile file{m_chainstate->m_blockman.OpenBlockFile(postx, true)};
-    if (file.IsNull()) {
-        LogError("%s: OpenBlockFile failed\n", __func__);
-        return false;
+    std::vector<std::pair<CDiskTxPos, size_t>> to_read;
+    to_read.reserve(missing.size());
+    for (const size_t i : missing) {
+        CDiskTxPos postx;
+        if (m_db->ReadTxPos(tx_hashes[i], postx)) {
+            to_read.emplace_back(postx, i);
+        }
     }
-    CBlockHeader header;
-    try {
-        file >> header;
-        file.seek(postx.nTxOffset, SEEK_CUR);
-        file >> TX_WITH_WITNESS(tx);
-    } catch (const std::exception& e) {
-        LogError("%s: Deserialize or I/O error - %s\n", __func__, e.what());
-        return false;
+    // Read transactions in the order they are stored in, so that block files are read forward.
+    std::sort(to_read.begin(), to_read.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first.nFile, a.first.nPos, a.first.nTxOffset) < std::tie(b.first.nFile, b.first.nPos, b.first.nTxOffset);
+    });
+
+    for (const auto& [postx, i] : to_read) {
+        CBlockHeader header;
+        CTransactionRef tx;
+        if (!m_chainstate->m_blockman.ReadTxFromDisk(postx, postx.nTxOffset, header, tx)) {
+            continue;
+        }
+        if (tx->GetHash() != tx_hashes[i]) {
+            LogError("%s: txid mismatch\n", __func__);
+            continue;
+        }
+        txs_out[i] = {header.GetHash(), std::move(tx)};
     }
-    if (tx->GetHash() != tx_hash) {
-        LogError("%s: txid mismatch\n", __func__);
-        return false;
+
+    LOCK(m_tx_cache_mutex);
+    if (epoch != m_tx_cache_epoch) return;
+    for (const auto& [postx, i] : to_read) {
+        const auto& [block_hash, tx]{txs_out[i]};
+        if (tx) m_tx_cache.Put(tx_hashes[i], CachedTx{block_hash, tx}, tx->GetTotalSize());
     }
-    block_hash = header.GetHash();
-    return true;
 }
@@ -6,13 +6,23 @@
 #define BITCOIN_INDEX_TXINDEX_H
 
 #include <index/base.h>
+#include <primitives/transaction.h>
+#include <span.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+#include <util/lru_cache.h>
+
+#include <utility>
+#include <vector>
 
 static constexpr bool DEFAULT_TXINDEX{false};
 
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
  * The index is written to a LevelDB database and records the filesystem
- * location of each transaction by transaction hash.
+ * location of each transaction by transaction hash. Recently looked up
+ * transactions are kept in memory.
  */
 class TxIndex final : public BaseIndex
 {
@@ -22,15 +32,33 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    /** A looked up transaction, with the hash of the block it was found in. */
+    struct CachedTx {
+        uint256 block_hash;
+        CTransactionRef tx;
+    };
+
+    mutable Mutex m_tx_cache_mutex;
+    /** Recently looked up transactions by hash, bounded by their total serialized size. */
+    mutable LRUCache<uint256, CachedTx, SaltedTxidHasher> m_tx_cache GUARDED_BY(m_tx_cache_mutex);
+    /** Incremented whenever a block is appended, so that lookups racing with it don't cache
+     *  transactions found at positions the block overwrote. */
+    uint64_t m_tx_cache_epoch GUARDED_BY(m_tx_cache_mutex){0};
+
     bool AllowPrune() const override { return false; }
 
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared) override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
-    /// Constructs the index, which becomes available to be queried.
+    /// Constructs the index, which becomes available to be queried. n_cache_size is split evenly
+    /// between the database cache and the cache of recently looked up transactions.
     explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
     // Destructor is declared because this class contains a unique_ptr to an incomplete type.
@@ -42,7 +70,15 @@ public:
     /// @param[out]  block_hash  The hash of the block the transaction is found in.
     /// @param[out]  tx  The transaction itself.
     /// @return  true if transaction is found, false otherwise
-    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_tx_cache_mutex);
+
+    /// Look up many transactions by hash. Transactions are read from disk in the order they are
+    /// stored in, which is faster than looking them up one by one.
+    ///
+    /// @param[in]   tx_hashes  The hashes of the transactions to be returned.
+    /// @param[out]  txs_out  For each hash, the hash of the block the transaction is found in and
+    ///                       the transaction itself, which is null if the transaction is not found.
+    void FindTxs(Span<const uint256> tx_hashes, std::vector<std::pair<uint256, CTransactionRef>>& txs_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_tx_cache_mutex);
 };
 
 /// The global transaction index, used in GetTransaction. May be null.
@@ -0,0 +1,166 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/txospenderindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <validation.h>
+
+#include <algorithm>
+
+/* The index database stores one entry per spent output, with a key of the
+ * type [DB_TXOSPENDER, COutPoint] and a TxoSpender value.
+ */
+constexpr uint8_t DB_TXOSPENDER{'o'};
+
+/** Number of pending entries above which they are written to the database
+ * before the next commit during the initial sync */
+static constexpr size_t MAX_PENDING_SPENDERS{500'000};
+
+namespace {
+
+using Spenders = std::vector<std::pair<COutPoint, TxoSpender>>;
+
+Spenders GetBlockSpenders(const CBlock& block, uint32_t height)
+{
+    Spenders spenders;
+    // The coinbase tx spends no output
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        for (const CTxIn& txin : tx.vin) {
+            spenders.emplace_back(txin.prevout, TxoSpender{tx.GetHash(), height});
+        }
+    }
+    return spenders;
+}
+
+/** Sort entries by outpoint, which makes for cheaper insertion into the database */
+void SortSpenders(Spenders& spenders)
+{
+    std::sort(spenders.begin(), spenders.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+}
+
+} // namespace
+
+std::unique_ptr<TxoSpenderIndex> g_txospender_index;
+
+/** Access to the txospenderindex database (indexes/txospenderindex/) */
+class TxoSpenderIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Add a batch of spent outputs to a database batch.
+    void WriteSpenders(CDBBatch& batch, const Spenders& spenders);
+
+    /// Write a batch of spent outputs to the DB.
+    [[nodiscard]] bool WriteSpenders(const Spenders& spenders);
+};
+
+TxoSpenderIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txospenderindex", n_cache_size, f_memory, f_wipe)
+{}
+
+void TxoSpenderIndex::DB::WriteSpenders(CDBBatch& batch, const Spenders& spenders)
+{
+    for (const auto& [prevout, spender] : spenders) {
+        batch.Write(std::make_pair(DB_TXOSPENDER, prevout), spender);
+    }
+}
+
+bool TxoSpenderIndex::DB::WriteSpenders(const Spenders& spenders)
+{
+    CDBBatch batch(*this);
+    WriteSpenders(batch, spenders);
+    return WriteBatch(batch);
+}
+
+TxoSpenderIndex::TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "txospenderindex"), m_db(std::make_unique<TxoSpenderIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TxoSpenderIndex::~TxoSpenderIndex() = default;
+
+BaseIndex::DB& TxoSpenderIndex::GetDB() const { return *m_db; }
+
+bool TxoSpenderIndex::FlushPending()
+{
+    if (m_pending.empty()) return true;
+    SortSpenders(m_pending);
+    if (!m_db->WriteSpenders(m_pending)) return false;
+    m_pending.clear();
+    return true;
+}
+
+bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // Blocks connected once the index is in sync are written right away, so
+    // that they can be looked up immediately.
+    return FlushPending() && m_db->WriteSpenders(GetBlockSpenders(*Assert(block.data), block.height));
+}
+
+bool TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    prepared = GetBlockSpenders(*Assert(block.data), block.height);
+    return true;
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared)
+{
+    // Only called during the initial sync, before the index becomes
+    // queryable, so the entries can wait for the next commit.
+    Spenders& spenders{std::any_cast<Spenders&>(prepared)};
+    m_pending.insert(m_pending.end(), std::make_move_iterator(spenders.begin()), std::make_move_iterator(spenders.end()));
+    if (m_pending.size() >= MAX_PENDING_SPENDERS) return FlushPending();
+    return true;
+}
+
+bool TxoSpenderIndex::CustomCommit(CDBBatch& batch)
+{
+    SortSpenders(m_pending);
+    m_db->WriteSpenders(batch, m_pending);
+    m_pending.clear();
+    return true;
+}
+
+bool TxoSpenderIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    // Pending entries may belong to the disconnected blocks
+    if (!FlushPending()) return false;
+
+    const CBlockIndex* iter_tip;
+    const CBlockIndex* new_tip_index;
+    {
+        LOCK(cs_main);
+        iter_tip = m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash);
+        new_tip_index = m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash);
+    }
+
+    CDBBatch batch(*m_db);
+    for (; iter_tip != new_tip_index; iter_tip = iter_tip->pprev) {
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+            LogError("%s: Failed to read block %s from disk\n", __func__, iter_tip->GetBlockHash().ToString());
+            return false;
+        }
+        for (const auto& [prevout, spender] : GetBlockSpenders(block, iter_tip->nHeight)) {
+            batch.Erase(std::make_pair(DB_TXOSPENDER, prevout));
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+std::optional<TxoSpender> TxoSpenderIndex::FindSpender(const COutPoint& prevout) const
+{
+    TxoSpender spender;
+    if (!m_db->Read(std::make_pair(DB_TXOSPENDER, prevout), spender)) {
+        return std::nullopt;
+    }
+    return spender;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TXOSPENDERINDEX_H
+#define BITCOIN_INDEX_TXOSPENDERINDEX_H
+
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+static constexpr bool DEFAULT_TXOSPENDERINDEX{false};
+
+/** The transaction spending an output, as recorded by the TxoSpenderIndex. */
+struct TxoSpender {
+    Txid txid;
+    /** Height of the block containing the spending transaction */
+    uint32_t height{0};
+
+    SERIALIZE_METHODS(TxoSpender, obj) { READWRITE(obj.txid, VARINT(obj.height)); }
+};
+
+/**
+ * TxoSpenderIndex maps each transaction output spent in the block chain to
+ * the transaction spending it.
+ *
+ * While the index catches up with the chain, e.g. when it is built from
+ * scratch, entries are written in bulk: they are buffered across blocks and
+ * written with the index state on commit, or earlier when the buffer is full.
+ */
+class TxoSpenderIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /** Entries of the blocks appended during the initial sync that are not
+     * written yet. Only used by the sync thread, and empty once the index is
+     * in sync. */
+    std::vector<std::pair<COutPoint, TxoSpender>> m_pending;
+
+    bool AllowPrune() const override { return true; }
+
+    /** Write the pending entries to the database. */
+    [[nodiscard]] bool FlushPending();
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any& prepared) override;
+
+    bool CustomCommit(CDBBatch& batch) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TxoSpenderIndex() override;
+
+    /// Look up the transaction spending an output.
+    ///
+    /// @param[in]   prevout  The output to look up.
+    /// @return  the spending transaction, or std::nullopt if the output is not spent in the block chain.
+    std::optional<TxoSpender> FindSpender(const COutPoint& prevout) const;
+};
+
+/// The global transaction output spender index. May be null.
+extern std::unique_ptr<TxoSpenderIndex> g_txospender_index;
+
+#endif // BITCOIN_INDEX_TXOSPENDERINDEX_H
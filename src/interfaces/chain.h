@@ -266,6 +266,11 @@ public:
     //  shared ancestry by multiple UTXOs after coin selection.
     virtual std::optional<CAmount> calculateCombinedBumpFee(const std::vector<COutPoint>& outpoints, const CFeeRate& target_feerate) = 0;
 
+    //! Calculate the combined bump fee for each of several input sets, as
+    //  calculateCombinedBumpFee(…) would for each of them separately. The
+    //  mempool clusters of all input sets are only looked up once.
+    virtual std::vector<std::optional<CAmount>> calculateCombinedBumpFees(const std::vector<std::vector<COutPoint>>& outpoint_sets, const CFeeRate& target_feerate) = 0;
+
     //! Get the node's package limits.
     //! Currently only returns the ancestor and descendant count limits, but could be enhanced to
     //! return more policy settings.
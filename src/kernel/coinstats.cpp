@@ -6,6 +6,7 @@
 
 #include <chain.h>
 #include <coins.h>
+#include <crypto/common.h>
 #include <crypto/muhash.h>
 #include <hash.h>
 #include <logging.h>
@@ -20,15 +21,24 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/thread.h>
+#include <util/time.h>
 #include <validation.h>
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -55,7 +65,7 @@ static void TxOutSer(T& ss, const COutPoint& outpoint, const Coin& coin)
     ss << coin.out;
 }
 
-static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin)
 {
     TxOutSer(ss, outpoint, coin);
 }
@@ -111,37 +121,180 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Number of coins between calls to the progress callback, when computing
+//! statistics on the calling thread.
+static constexpr uint64_t PROGRESS_INTERVAL{1 << 16};
+//! Time between calls to the progress callback, when computing statistics on
+//! separate threads.
+static constexpr auto PROGRESS_REPORT_INTERVAL{1s};
+
+//! The first 32 bits of a txid in database order, which are used to estimate
+//! the fraction of the coins database processed.
+static uint32_t TxidPrefix(const Txid& txid)
+{
+    return ReadBE32(txid.ToUint256().data());
+}
+
+//! A range of the coins database whose statistics are computed separately.
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+struct CoinsRange {
+    std::unique_ptr<CCoinsViewCursor> cursor;
+    //! First txid prefix of the range
+    uint64_t start;
+    //! First txid prefix after the range
+    uint64_t end;
+    //! Prefix of the txid of the coins being processed
+    std::atomic<uint64_t> position;
+    CCoinsStats stats{};
+    T hash_obj{};
+    bool success{false};
+    std::exception_ptr error;
+
+    CoinsRange(std::unique_ptr<CCoinsViewCursor> cursor_in, uint64_t start_in, uint64_t end_in)
+        : cursor{std::move(cursor_in)}, start{start_in}, end{end_in}, position{start_in} {}
+};
+
+//! Calculate statistics about the coins of a range of the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CoinsRange<T>& range, const std::function<void()>& interruption_point,
+                             const std::function<void()>& progress_point, const std::atomic<bool>& stop)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
+    CCoinsViewCursor& cursor{*range.cursor};
+    CCoinsStats& stats{range.stats};
 
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
+        if (stop.load(std::memory_order_relaxed)) return false;
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
+            if (key.hash != prevkey) {
+                const uint64_t position{TxidPrefix(key.hash)};
+                if (position >= range.end) break;
+                range.position.store(position, std::memory_order_relaxed);
+            }
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
-                ApplyHash(hash_obj, prevkey, outputs);
+                ApplyHash(range.hash_obj, prevkey, outputs);
                 outputs.clear();
             }
             prevkey = key.hash;
             outputs[key.n] = std::move(coin);
             stats.coins_count++;
+            if (progress_point && stats.coins_count % PROGRESS_INTERVAL == 0) progress_point();
         } else {
             LogError("%s: unable to read value\n", __func__);
             return false;
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
-        ApplyHash(hash_obj, prevkey, outputs);
+        ApplyHash(range.hash_obj, prevkey, outputs);
+    }
+    range.position.store(range.end, std::memory_order_relaxed);
+    return true;
+}
+
+static void CombineHash(HashWriter& hash_obj, HashWriter& range_hash_obj, size_t num_ranges)
+{
+    // The serialized hash depends on the order of the coins, so it is never
+    // computed in separate ranges.
+    assert(num_ranges == 1);
+    hash_obj = std::move(range_hash_obj);
+}
+static void CombineHash(MuHash3072& muhash, const MuHash3072& range_muhash, size_t num_ranges) { muhash *= range_muhash; }
+static void CombineHash(std::nullptr_t, std::nullptr_t, size_t num_ranges) {}
+
+static void CombineStats(CCoinsStats& stats, const CCoinsStats& range_stats)
+{
+    stats.nTransactions += range_stats.nTransactions;
+    stats.nTransactionOutputs += range_stats.nTransactionOutputs;
+    stats.nBogoSize += range_stats.nBogoSize;
+    stats.coins_count += range_stats.coins_count;
+    if (stats.total_amount.has_value() && range_stats.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *range_stats.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point, const UTXOStatsOptions& options)
+{
+    // Split the database into ranges of txids, which are uniformly distributed,
+    // each processed by its own thread. This is only possible if the hash does
+    // not depend on the order of the coins.
+    constexpr uint64_t PREFIXES{uint64_t{1} << 32};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    if (!std::is_same_v<T, HashWriter> && options.threads > 1) {
+        std::vector<Txid> starts;
+        for (int i = 0; i < options.threads; ++i) {
+            uint256 start;
+            WriteBE32(start.data(), static_cast<uint32_t>(PREFIXES * i / options.threads));
+            starts.push_back(Txid::FromUint256(start));
+        }
+        cursors = view->Cursors(starts);
+    }
+    std::vector<std::unique_ptr<CoinsRange<T>>> ranges;
+    if (cursors.empty()) {
+        ranges.push_back(std::make_unique<CoinsRange<T>>(view->Cursor(), 0, PREFIXES));
+        assert(ranges.back()->cursor);
+    } else {
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            ranges.push_back(std::make_unique<CoinsRange<T>>(std::move(cursors[i]), PREFIXES * i / cursors.size(), PREFIXES * (i + 1) / cursors.size()));
+        }
+    }
+
+    const auto report_progress{[&] {
+        if (!options.progress) return;
+        uint64_t done{0};
+        for (const auto& range : ranges) {
+            done += range->position.load(std::memory_order_relaxed) - range->start;
+        }
+        options.progress(static_cast<double>(done) / PREFIXES);
+    }};
+
+    std::atomic<bool> stop{false};
+    if (ranges.size() == 1) {
+        ranges[0]->success = ComputeUTXOStats(*ranges[0], interruption_point, report_progress, stop);
+    } else {
+        Mutex mutex;
+        std::condition_variable cv;
+        size_t done{0};
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            threads.emplace_back(&util::TraceThread, strprintf("coinstats.%i", i), [&, &range = *ranges[i]] {
+                try {
+                    range.success = ComputeUTXOStats(range, interruption_point, {}, stop);
+                } catch (...) {
+                    range.error = std::current_exception();
+                }
+                if (!range.success) stop = true;
+                WITH_LOCK(mutex, ++done);
+                cv.notify_all();
+            });
+        }
+        {
+            WAIT_LOCK(mutex, lock);
+            while (!cv.wait_for(lock, PROGRESS_REPORT_INTERVAL, [&]() EXCLUSIVE_LOCKS_REQUIRED(mutex) { return done == ranges.size(); })) {
+                REVERSE_LOCK(lock);
+                report_progress();
+            }
+        }
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    for (const auto& range : ranges) {
+        if (range->error) std::rethrow_exception(range->error);
+    }
+    for (const auto& range : ranges) {
+        if (!range->success) return false;
+        CombineStats(stats, range->stats);
+        CombineHash(hash_obj, range->hash_obj, ranges.size());
     }
 
     FinalizeHash(hash_obj, stats);
@@ -151,7 +304,7 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, const UTXOStatsOptions& options)
 {
     CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
     CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
@@ -160,14 +313,14 @@ std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsV
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return ComputeUTXOStats(view, stats, ss, interruption_point, options);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            return ComputeUTXOStats(view, stats, muhash, interruption_point, options);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            return ComputeUTXOStats(view, stats, nullptr, interruption_point, options);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
@@ -7,6 +7,7 @@
 
 #include <consensus/amount.h>
 #include <crypto/muhash.h>
+#include <hash.h>
 #include <streams.h>
 #include <uint256.h>
 
@@ -73,10 +74,24 @@ struct CCoinsStats {
 
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
+//! Add a coin to the HASH_SERIALIZED hash. The coins of a transaction are
+//! hashed by increasing output index, and transactions in database order.
+void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin& coin);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+//! How to compute statistics about the unspent transaction output set.
+struct UTXOStatsOptions {
+    //! Number of threads processing separate ranges of the coins database.
+    //! Only used if the hash does not depend on the order of the coins, i.e.
+    //! not for HASH_SERIALIZED, and if the view supports it.
+    int threads{1};
+    //! Called on the calling thread with the estimated fraction of the coins
+    //! processed so far.
+    std::function<void(double)> progress{};
+};
+
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, const UTXOStatsOptions& options = {});
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
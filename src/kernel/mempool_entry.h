@@ -185,6 +185,7 @@ public:
     Children& GetMemPoolChildren() const { return m_children; }
 
     mutable size_t idx_randomized; //!< Index in mempool's txns_randomized
+    mutable size_t m_feerate_bucket{0}; //!< Bucket of the mempool's feerate histogram this entry is counted in
     mutable Epoch::Marker m_epoch_marker; //!< epoch when last touched, useful for graph algorithms
 };
 
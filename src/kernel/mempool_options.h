@@ -10,6 +10,7 @@
 #include <policy/policy.h>
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 
@@ -25,6 +26,8 @@ static constexpr unsigned int DEFAULT_MEMPOOL_EXPIRY_HOURS{336};
 static constexpr bool DEFAULT_MEMPOOL_FULL_RBF{true};
 /** Whether to fall back to legacy V1 serialization when writing mempool.dat */
 static constexpr bool DEFAULT_PERSIST_V1_DAT{false};
+/** Default for -mempooleventlog, number of mempool additions and removals kept for replay */
+static constexpr unsigned int DEFAULT_MEMPOOL_EVENT_LOG_SIZE{50'000};
 /** Default for -acceptnonstdtxn */
 static constexpr bool DEFAULT_ACCEPT_NON_STD_TXN{false};
 
@@ -57,6 +60,8 @@ struct MemPoolOptions {
     bool require_standard{true};
     bool full_rbf{DEFAULT_MEMPOOL_FULL_RBF};
     bool persist_v1_dat{DEFAULT_PERSIST_V1_DAT};
+    /** Number of mempool events retained for replay by sequence number */
+    size_t event_log_size{DEFAULT_MEMPOOL_EVENT_LOG_SIZE};
     MemPoolLimits limits{};
 
     ValidationSignals* signals{nullptr};
@@ -802,6 +802,9 @@ uint64_t BlockManager::CalculateCurrentUsage()
 
 void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 {
+    // Open files cannot be removed on some platforms.
+    WITH_LOCK(m_read_files_mutex, std::erase_if(m_read_files, [&](const auto& entry) { return setFilesToPrune.count(entry.first); }));
+
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
@@ -1060,6 +1063,48 @@ bool BlockManager::ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) cons
     return true;
 }
 
+bool BlockManager::ReadTxFromDisk(const FlatFilePos& block_pos, uint32_t tx_offset, CBlockHeader& header, CTransactionRef& tx)
+{
+    // The contents of a block file only change while blocks are appended to it, so only handles
+    // of other files, and the data they buffered, can be reused.
+    const bool reusable{WITH_LOCK(cs_LastBlockFile, return std::none_of(m_blockfile_cursors.begin(), m_blockfile_cursors.end(),
+        [&](const auto& cursor) { return cursor && cursor->file_num == block_pos.nFile; }))};
+
+    std::unique_ptr<AutoFile> filein;
+    if (reusable) {
+        LOCK(m_read_files_mutex);
+        const auto it{std::find_if(m_read_files.begin(), m_read_files.end(), [&](const auto& entry) { return entry.first == block_pos.nFile; })};
+        if (it != m_read_files.end()) {
+            filein = std::move(it->second);
+            m_read_files.erase(it);
+        }
+    }
+    if (!filein) {
+        filein = std::make_unique<AutoFile>(m_block_file_seq.Open(FlatFilePos{block_pos.nFile, 0}, true), m_xor_key);
+        if (filein->IsNull()) {
+            LogError("%s: OpenBlockFile failed for %s\n", __func__, block_pos.ToString());
+            return false;
+        }
+    }
+
+    try {
+        filein->seek(block_pos.nPos, SEEK_SET);
+        *filein >> header;
+        filein->seek(tx_offset, SEEK_CUR);
+        *filein >> TX_WITH_WITNESS(tx);
+    } catch (const std::exception& e) {
+        LogError("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), block_pos.ToString());
+        return false;
+    }
+
+    if (reusable) {
+        LOCK(m_read_files_mutex);
+        m_read_files.emplace_front(block_pos.nFile, std::move(filein));
+        if (m_read_files.size() > MAX_OPEN_READ_BLOCK_FILES) m_read_files.pop_back();
+    }
+    return true;
+}
+
 bool BlockManager::ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) const
 {
     const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -73,6 +74,8 @@ static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
+/** The maximum number of block files kept open for reading transactions */
+static constexpr size_t MAX_OPEN_READ_BLOCK_FILES{8};
 
 /** Size of header written by WriteBlockToDisk before a serialized CBlock */
 static constexpr size_t BLOCK_SERIALIZATION_HEADER_SIZE = std::tuple_size_v<MessageStartChars> + sizeof(unsigned int);
@@ -264,6 +267,11 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    mutable Mutex m_read_files_mutex;
+    /** Read-only handles of block files no longer appended to, kept open between reads, most
+     *  recently used first. A handle is removed from the list while it is in use. */
+    mutable std::list<std::pair<int, std::unique_ptr<AutoFile>>> m_read_files GUARDED_BY(m_read_files_mutex);
+
 public:
     using Options = kernel::BlockManagerOpts;
 
@@ -418,13 +426,21 @@ public:
     /**
      *  Actually unlink the specified files
      */
-    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
+    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const EXCLUSIVE_LOCKS_REQUIRED(!m_read_files_mutex);
 
     /** Functions for disk access for blocks */
     bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) const;
     bool ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) const;
     bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos) const;
 
+    /**
+     * Read the header of a block and one of its transactions, found tx_offset bytes after the
+     * header. Handles of block files are kept open across calls, which makes reading many
+     * transactions from the same files, preferably in order, cheap.
+     */
+    bool ReadTxFromDisk(const FlatFilePos& block_pos, uint32_t tx_offset, CBlockHeader& header, CTransactionRef& tx)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_read_files_mutex);
+
     bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
     void CleanupBlockRevFiles() const;
@@ -46,7 +46,9 @@ static ChainstateLoadResult CompleteChainstateInitialization(
         .cache_bytes = static_cast<size_t>(cache_sizes.block_tree_db),
         .memory_only = options.block_tree_db_in_memory,
         .wipe_data = options.wipe_block_tree_db,
-        .options = chainman.m_options.block_tree_db});
+        .options = chainman.m_options.block_tree_db,
+        // Block index entries are rewritten as blocks are validated, and compress well.
+        .tuning = DBTuning{.compression = true}});
 
     if (options.wipe_block_tree_db) {
         pblocktree->WriteReindexing(true);
@@ -62,6 +62,9 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     // Subtract 1 because the main thread counts towards the par threads.
     opts.worker_threads_num = std::clamp(script_threads - 1, 0, MAX_SCRIPTCHECK_THREADS);
     LogPrintf("Script verification uses %d additional threads\n", opts.worker_threads_num);
+    // Load blocks on as many threads, and at least one so that reading blocks
+    // from disk overlaps with validating them.
+    opts.block_load_threads = std::clamp(script_threads - 1, 1, MAX_BLOCK_LOAD_THREADS);
 
     if (auto max_size = args.GetIntArg("-maxsigcachesize")) {
         // 1. When supplied with a max_size of 0, both the signature cache and
@@ -7,10 +7,14 @@
 #include <common/args.h>
 #include <txdb.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace node {
 void ReadCoinsViewArgs(const ArgsManager& args, CoinsViewOptions& options)
 {
     if (auto value = args.GetIntArg("-dbbatchsize")) options.batch_write_bytes = *value;
     if (auto value = args.GetIntArg("-dbcrashratio")) options.simulate_crash_ratio = *value;
+    if (auto value = args.GetIntArg("-dbreadthreads")) options.read_threads = std::clamp<int64_t>(*value, 0, MAX_DB_READ_THREADS);
 }
 } // namespace node
@@ -51,6 +51,7 @@
 #include <uint256.h>
 #include <univalue.h>
 #include <util/check.h>
+#include <util/rbf.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/string.h>
@@ -660,18 +661,31 @@ public:
     RBFTransactionState isRBFOptIn(const CTransaction& tx) override
     {
         if (!m_node.mempool) return IsRBFOptInEmptyMempool(tx);
+        if (const auto snapshot{m_node.mempool->GetCurrentSnapshot()}) {
+            if (SignalsOptInRBF(tx)) return RBFTransactionState::REPLACEABLE_BIP125;
+            const MempoolSnapshot::Entry* entry{snapshot->Find(tx.GetHash())};
+            if (!entry) return RBFTransactionState::UNKNOWN;
+            return entry->bip125_replaceable ? RBFTransactionState::REPLACEABLE_BIP125 : RBFTransactionState::FINAL;
+        }
         LOCK(m_node.mempool->cs);
         return IsRBFOptIn(tx, *m_node.mempool);
     }
     bool isInMempool(const uint256& txid) override
     {
         if (!m_node.mempool) return false;
+        if (const auto snapshot{m_node.mempool->GetCurrentSnapshot()}) {
+            return snapshot->Find(Txid::FromUint256(txid)) != nullptr;
+        }
         LOCK(m_node.mempool->cs);
         return m_node.mempool->exists(GenTxid::Txid(txid));
     }
     bool hasDescendantsInMempool(const uint256& txid) override
     {
         if (!m_node.mempool) return false;
+        if (const auto snapshot{m_node.mempool->GetCurrentSnapshot()}) {
+            const MempoolSnapshot::Entry* entry{snapshot->Find(Txid::FromUint256(txid))};
+            return entry != nullptr && entry->count_with_descendants > 1;
+        }
         LOCK(m_node.mempool->cs);
         const auto entry{m_node.mempool->GetEntry(Txid::FromUint256(txid))};
         if (entry == nullptr) return false;
@@ -704,7 +718,7 @@ public:
             }
             return bump_fees;
         }
-        return MiniMiner(*m_node.mempool, outpoints).CalculateBumpFees(target_feerate);
+        return MiniMiner(*m_node.mempool, outpoints, m_mini_miner_cache).CalculateBumpFees(target_feerate);
     }
 
     std::optional<CAmount> calculateCombinedBumpFee(const std::vector<COutPoint>& outpoints, const CFeeRate& target_feerate) override
@@ -712,7 +726,27 @@ public:
         if (!m_node.mempool) {
             return 0;
         }
-        return MiniMiner(*m_node.mempool, outpoints).CalculateTotalBumpFees(target_feerate);
+        return MiniMiner(*m_node.mempool, outpoints, m_mini_miner_cache).CalculateTotalBumpFees(target_feerate);
+    }
+
+    std::vector<std::optional<CAmount>> calculateCombinedBumpFees(const std::vector<std::vector<COutPoint>>& outpoint_sets, const CFeeRate& target_feerate) override
+    {
+        if (!m_node.mempool) {
+            return std::vector<std::optional<CAmount>>(outpoint_sets.size(), 0);
+        }
+        // Copy the clusters of all input sets out of the mempool at once.
+        std::vector<COutPoint> all_outpoints;
+        for (const auto& outpoints : outpoint_sets) {
+            all_outpoints.insert(all_outpoints.end(), outpoints.begin(), outpoints.end());
+        }
+        (void)m_mini_miner_cache.GetClusters(*m_node.mempool, all_outpoints);
+
+        std::vector<std::optional<CAmount>> bump_fees;
+        bump_fees.reserve(outpoint_sets.size());
+        for (const auto& outpoints : outpoint_sets) {
+            bump_fees.push_back(MiniMiner(*m_node.mempool, outpoints, m_mini_miner_cache).CalculateTotalBumpFees(target_feerate));
+        }
+        return bump_fees;
     }
     void getPackageLimits(unsigned int& limit_ancestor_count, unsigned int& limit_descendant_count) override
     {
@@ -862,6 +896,7 @@ public:
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     ValidationSignals& validation_signals() { return *Assert(m_node.validation_signals); }
     NodeContext& m_node;
+    MiniMinerClusterCache m_mini_miner_cache;
 };
 
 class BlockTemplateImpl : public BlockTemplate
@@ -18,7 +18,9 @@
 #include <util/moneystr.h>
 #include <util/translation.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <memory>
 
 using common::AmountErrMsg;
@@ -99,6 +101,8 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& argsman, const CChainP
 
     mempool_opts.persist_v1_dat = argsman.GetBoolArg("-persistmempoolv1", mempool_opts.persist_v1_dat);
 
+    if (auto size = argsman.GetIntArg("-mempooleventlog")) mempool_opts.event_log_size = std::max<int64_t>(*size, 0);
+
     ApplyArgsManOptions(argsman, mempool_opts.limits);
 
     return {};
@@ -20,14 +20,139 @@
 
 namespace node {
 
+void MiniMinerClusterCache::Reset(uint64_t epoch)
+{
+    AssertLockHeld(m_mutex);
+    m_epoch = epoch;
+    m_clusters.clear();
+    m_not_in_mempool.clear();
+}
+
+std::optional<std::vector<std::shared_ptr<const MiniMinerCluster>>> MiniMinerClusterCache::GetClusters(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints)
+{
+    std::set<Txid> txids;
+    for (const auto& outpoint : outpoints) {
+        txids.insert(outpoint.hash);
+    }
+
+    std::set<std::shared_ptr<const MiniMinerCluster>> clusters;
+    std::vector<Txid> missing;
+    {
+        LOCK(m_mutex);
+        const uint64_t epoch{mempool.GetSnapshotEpoch()};
+        if (m_epoch != epoch) Reset(epoch);
+        for (const auto& txid : txids) {
+            if (const auto it{m_clusters.find(txid)}; it != m_clusters.end()) {
+                clusters.insert(it->second);
+            } else if (!m_not_in_mempool.count(txid)) {
+                missing.push_back(txid);
+            }
+        }
+    }
+
+    if (!missing.empty()) {
+        LOCK(mempool.cs);
+        LOCK(m_mutex);
+        if (m_epoch != mempool.GetSnapshotEpoch()) {
+            // The mempool changed since the cache was consulted above, start over.
+            Reset(mempool.GetSnapshotEpoch());
+            clusters.clear();
+            missing.assign(txids.begin(), txids.end());
+        }
+        if (m_clusters.size() + missing.size() > MAX_CACHED_TXS) Reset(*m_epoch);
+
+        std::vector<uint256> txids_needed;
+        for (const auto& txid : missing) {
+            if (mempool.exists(GenTxid::Txid(txid))) {
+                txids_needed.push_back(txid);
+            } else {
+                m_not_in_mempool.insert(txid);
+            }
+        }
+        if (!txids_needed.empty()) {
+            const auto cluster{mempool.GatherClusters(txids_needed)};
+            // An empty cluster means that at least one of the transactions is missing from the
+            // mempool (should not be possible given processing above) or DoS limit was hit.
+            if (cluster.empty()) return std::nullopt;
+
+            // Split the gathered transactions into their connected components.
+            std::set<uint256> assigned;
+            for (const auto& seed : cluster) {
+                if (!assigned.insert(seed->GetTx().GetHash()).second) continue;
+                auto component{std::make_shared<MiniMinerCluster>()};
+                std::vector<CTxMemPool::txiter> to_process{seed};
+                while (!to_process.empty()) {
+                    const CTxMemPool::txiter txiter{to_process.back()};
+                    to_process.pop_back();
+                    const Txid& txid{txiter->GetTx().GetHash()};
+                    component->entries.emplace(txid,
+                        MiniMinerMempoolEntry{/*tx_in=*/txiter->GetSharedTx(),
+                                              /*vsize_self=*/txiter->GetTxSize(),
+                                              /*vsize_ancestor=*/txiter->GetSizeWithAncestors(),
+                                              /*fee_self=*/txiter->GetModifiedFee(),
+                                              /*fee_ancestor=*/txiter->GetModFeesWithAncestors()});
+                    CTxMemPool::setEntries descendants;
+                    mempool.CalculateDescendants(txiter, descendants);
+                    Assume(descendants.count(txiter) > 0);
+                    auto& cached_descendants{component->descendants[txid]};
+                    for (const auto& desc_txiter : descendants) {
+                        cached_descendants.push_back(desc_txiter->GetTx().GetHash());
+                    }
+                    for (const auto& relatives : {txiter->GetMemPoolParentsConst(), txiter->GetMemPoolChildrenConst()}) {
+                        for (const CTxMemPoolEntry& relative : relatives) {
+                            if (assigned.insert(relative.GetTx().GetHash()).second) {
+                                to_process.push_back(mempool.mapTx.iterator_to(relative));
+                            }
+                        }
+                    }
+                }
+                for (const auto& [txid, _] : component->entries) {
+                    m_clusters.emplace(txid, component);
+                }
+                clusters.insert(std::move(component));
+            }
+        }
+    }
+
+    // Same DoS limit as CTxMemPool::GatherClusters(), applied to all clusters together.
+    size_t num_txs{0};
+    for (const auto& cluster : clusters) {
+        num_txs += cluster->entries.size();
+    }
+    if (num_txs > 500) return std::nullopt;
+    return std::vector<std::shared_ptr<const MiniMinerCluster>>(clusters.begin(), clusters.end());
+}
+
 MiniMiner::MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints)
+    : MiniMiner{MiniMinerClusterCache{}.GetClusters(mempool, outpoints), outpoints}
+{
+}
+
+MiniMiner::MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints, MiniMinerClusterCache& cache)
+    : MiniMiner{cache.GetClusters(mempool, outpoints), outpoints}
+{
+}
+
+MiniMiner::MiniMiner(const std::optional<std::vector<std::shared_ptr<const MiniMinerCluster>>>& clusters,
+                     const std::vector<COutPoint>& outpoints)
 {
-    LOCK(mempool.cs);
+    if (!clusters) {
+        m_ready_to_calculate = false;
+        return;
+    }
+    std::map<Txid, const MiniMinerCluster*> cluster_by_txid;
+    for (const auto& cluster : *clusters) {
+        for (const auto& [txid, _] : cluster->entries) {
+            cluster_by_txid.emplace(txid, cluster.get());
+        }
+    }
+
     // Find which outpoints to calculate bump fees for.
     // Anything that's spent by the mempool is to-be-replaced
     // Anything otherwise unavailable just has a bump fee of 0
     for (const auto& outpoint : outpoints) {
-        if (!mempool.exists(GenTxid::Txid(outpoint.hash))) {
+        const auto cluster_it{cluster_by_txid.find(outpoint.hash)};
+        if (cluster_it == cluster_by_txid.end()) {
             // This UTXO is either confirmed or not yet submitted to mempool.
             // If it's confirmed, no bump fee is required.
             // If it's not yet submitted, we have no information, so return 0.
@@ -39,7 +164,13 @@ MiniMiner::MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& ou
         // Note: This will either create a missing entry or add the outpoint to an existing entry
         m_requested_outpoints_by_txid[outpoint.hash].push_back(outpoint);
 
-        if (const auto ptx{mempool.GetConflictTx(outpoint)}) {
+        // Any transaction spending this outpoint is a descendant of the transaction creating it.
+        const MiniMinerCluster& cluster{*cluster_it->second};
+        for (const auto& desc_txid : cluster.descendants.at(outpoint.hash)) {
+            const CTransaction& desc_tx{cluster.entries.at(desc_txid).GetTx()};
+            if (std::none_of(desc_tx.vin.begin(), desc_tx.vin.end(), [&](const CTxIn& txin) { return txin.prevout == outpoint; })) {
+                continue;
+            }
             // This outpoint is already being spent by another transaction in the mempool. We
             // assume that the caller wants to replace this transaction and its descendants. It
             // would be unusual for the transaction to have descendants as the wallet won’t normally
@@ -49,84 +180,62 @@ MiniMiner::MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& ou
             //
             // Note that the descendants of a transaction include the transaction itself. Also note,
             // that this is only calculating bump fees. RBF fee rules should be handled separately.
-            CTxMemPool::setEntries descendants;
-            mempool.CalculateDescendants(mempool.GetIter(ptx->GetHash()).value(), descendants);
-            for (const auto& desc_txiter : descendants) {
-                m_to_be_replaced.insert(desc_txiter->GetTx().GetHash());
+            for (const auto& replaced_txid : cluster.descendants.at(desc_txid)) {
+                m_to_be_replaced.insert(replaced_txid);
             }
+            break;
         }
     }
 
     // No unconfirmed UTXOs, so nothing mempool-related needs to be calculated.
     if (m_requested_outpoints_by_txid.empty()) return;
 
-    // Calculate the cluster and construct the entry map.
-    std::vector<uint256> txids_needed;
-    txids_needed.reserve(m_requested_outpoints_by_txid.size());
-    for (const auto& [txid, _]: m_requested_outpoints_by_txid) {
-        txids_needed.push_back(txid);
-    }
-    const auto cluster = mempool.GatherClusters(txids_needed);
-    if (cluster.empty()) {
-        // An empty cluster means that at least one of the transactions is missing from the mempool
-        // (should not be possible given processing above) or DoS limit was hit.
-        m_ready_to_calculate = false;
-        return;
-    }
-
-    // Add every entry to m_entries_by_txid and m_entries, except the ones that will be replaced.
-    for (const auto& txiter : cluster) {
-        if (!m_to_be_replaced.count(txiter->GetTx().GetHash())) {
-            auto [mapiter, success] = m_entries_by_txid.emplace(txiter->GetTx().GetHash(),
-                MiniMinerMempoolEntry{/*tx_in=*/txiter->GetSharedTx(),
-                                      /*vsize_self=*/txiter->GetTxSize(),
-                                      /*vsize_ancestor=*/txiter->GetSizeWithAncestors(),
-                                      /*fee_self=*/txiter->GetModifiedFee(),
-                                      /*fee_ancestor=*/txiter->GetModFeesWithAncestors()});
-            m_entries.push_back(mapiter);
-        } else {
-            auto outpoints_it = m_requested_outpoints_by_txid.find(txiter->GetTx().GetHash());
-            if (outpoints_it != m_requested_outpoints_by_txid.end()) {
-                // This UTXO is the output of a to-be-replaced transaction. Bump fee is 0; spending
-                // this UTXO is impossible as it will no longer exist after the replacement.
-                for (const auto& outpoint : outpoints_it->second) {
-                    m_bump_fees.emplace(outpoint, 0);
+    // Add every entry of the requested clusters to m_entries_by_txid and m_entries, except the
+    // ones that will be replaced.
+    for (const auto& cluster : *clusters) {
+        for (const auto& [txid, entry] : cluster->entries) {
+            if (!m_to_be_replaced.count(txid)) {
+                auto [mapiter, success] = m_entries_by_txid.emplace(txid, entry);
+                m_entries.push_back(mapiter);
+            } else {
+                auto outpoints_it = m_requested_outpoints_by_txid.find(txid);
+                if (outpoints_it != m_requested_outpoints_by_txid.end()) {
+                    // This UTXO is the output of a to-be-replaced transaction. Bump fee is 0; spending
+                    // this UTXO is impossible as it will no longer exist after the replacement.
+                    for (const auto& outpoint : outpoints_it->second) {
+                        m_bump_fees.emplace(outpoint, 0);
+                    }
+                    m_requested_outpoints_by_txid.erase(outpoints_it);
                 }
-                m_requested_outpoints_by_txid.erase(outpoints_it);
             }
         }
     }
 
     // Build the m_descendant_set_by_txid cache.
-    for (const auto& txiter : cluster) {
-        const auto& txid = txiter->GetTx().GetHash();
-        // Cache descendants for future use. Unlike the real mempool, a descendant MiniMinerMempoolEntry
-        // will not exist without its ancestor MiniMinerMempoolEntry, so these sets won't be invalidated.
-        std::vector<MockEntryMap::iterator> cached_descendants;
-        const bool remove{m_to_be_replaced.count(txid) > 0};
-        CTxMemPool::setEntries descendants;
-        mempool.CalculateDescendants(txiter, descendants);
-        Assume(descendants.count(txiter) > 0);
-        for (const auto& desc_txiter : descendants) {
-            const auto txid_desc = desc_txiter->GetTx().GetHash();
-            const bool remove_desc{m_to_be_replaced.count(txid_desc) > 0};
-            auto desc_it{m_entries_by_txid.find(txid_desc)};
-            Assume((desc_it == m_entries_by_txid.end()) == remove_desc);
-            if (remove) Assume(remove_desc);
-            // It's possible that remove=false but remove_desc=true.
-            if (!remove && !remove_desc) {
-                cached_descendants.push_back(desc_it);
+    for (const auto& cluster : *clusters) {
+        for (const auto& [txid, descendants] : cluster->descendants) {
+            // Cache descendants for future use. Unlike the real mempool, a descendant MiniMinerMempoolEntry
+            // will not exist without its ancestor MiniMinerMempoolEntry, so these sets won't be invalidated.
+            std::vector<MockEntryMap::iterator> cached_descendants;
+            const bool remove{m_to_be_replaced.count(txid) > 0};
+            for (const auto& txid_desc : descendants) {
+                const bool remove_desc{m_to_be_replaced.count(txid_desc) > 0};
+                auto desc_it{m_entries_by_txid.find(txid_desc)};
+                Assume((desc_it == m_entries_by_txid.end()) == remove_desc);
+                if (remove) Assume(remove_desc);
+                // It's possible that remove=false but remove_desc=true.
+                if (!remove && !remove_desc) {
+                    cached_descendants.push_back(desc_it);
+                }
+            }
+            if (remove) {
+                Assume(cached_descendants.empty());
+            } else {
+                m_descendant_set_by_txid.emplace(txid, cached_descendants);
             }
-        }
-        if (remove) {
-            Assume(cached_descendants.empty());
-        } else {
-            m_descendant_set_by_txid.emplace(txid, cached_descendants);
         }
     }
 
-    // Release the mempool lock; we now have all the information we need for a subset of the entries
-    // we care about. We will solely operate on the MiniMinerMempoolEntry map from now on.
     Assume(m_in_block.empty());
     Assume(m_requested_outpoints_by_txid.size() <= outpoints.size());
     SanityCheck();
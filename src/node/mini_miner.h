@@ -7,6 +7,7 @@
 
 #include <consensus/amount.h>
 #include <primitives/transaction.h>
+#include <sync.h>
 #include <uint256.h>
 
 #include <map>
@@ -57,6 +58,41 @@ public:
     }
 };
 
+/** The connected mempool cluster of one or more transactions, copied out of the mempool with
+ * everything MiniMiner needs to know about it. */
+struct MiniMinerCluster
+{
+    std::map<Txid, MiniMinerMempoolEntry> entries;
+    /** Descendant set of each entry, including the entry itself. */
+    std::map<Txid, std::vector<Txid>> descendants;
+};
+
+/** Mempool clusters shared by all MiniMiners constructed while the mempool does not change, so that
+ * repeated bump fee calculations over the same unconfirmed UTXOs (e.g. during coin selection) only
+ * walk the mempool once. Any mempool change invalidates the whole cache; clusters are then copied
+ * out again on demand. */
+class MiniMinerClusterCache
+{
+    Mutex m_mutex;
+    /** CTxMemPool::GetSnapshotEpoch() the cached clusters are valid for. */
+    std::optional<uint64_t> m_epoch GUARDED_BY(m_mutex);
+    /** Cluster of each cached mempool transaction. */
+    std::map<Txid, std::shared_ptr<const MiniMinerCluster>> m_clusters GUARDED_BY(m_mutex);
+    /** Transactions known not to be in the mempool. */
+    std::set<Txid> m_not_in_mempool GUARDED_BY(m_mutex);
+
+    void Reset(uint64_t epoch) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+public:
+    /** Maximum number of cached transactions, after which the cache is cleared. */
+    static constexpr size_t MAX_CACHED_TXS{10'000};
+
+    /** Return the clusters of all transactions creating the given outpoints that are in the
+     * mempool, or std::nullopt if those clusters are too large to be calculated. */
+    std::optional<std::vector<std::shared_ptr<const MiniMinerCluster>>> GetClusters(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
 // Comparator needed for std::set<MockEntryMap::iterator>
 struct IteratorComparator
 {
@@ -120,6 +156,10 @@ class MiniMiner
     /** Perform some checks. */
     void SanityCheck() const;
 
+    /** Constructor from clusters copied out of the mempool, see MiniMinerClusterCache::GetClusters(). */
+    MiniMiner(const std::optional<std::vector<std::shared_ptr<const MiniMinerCluster>>>& clusters,
+              const std::vector<COutPoint>& outpoints);
+
 public:
     /** Returns true if CalculateBumpFees may be called, false if not. */
     bool IsReadyToCalculate() const { return m_ready_to_calculate; }
@@ -137,6 +177,10 @@ public:
     */
     MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints);
 
+    /** Same as above, but reuses the clusters in the cache if the mempool has not changed since
+     * they were copied, and adds the clusters it copies to the cache. */
+    MiniMiner(const CTxMemPool& mempool, const std::vector<COutPoint>& outpoints, MiniMinerClusterCache& cache);
+
     /** Constructor in which the MiniMinerMempoolEntry entries have been constructed manually.
      * It is assumed that all entries are unique and their values are correct, otherwise results
      * computed by MiniMiner may be incorrect. Callers should check IsReadyToCalculate() after
@@ -4,6 +4,8 @@
 
 #include <node/utxo_snapshot.h>
 
+#include <consensus/amount.h>
+#include <kernel/coinstats.h>
 #include <logging.h>
 #include <streams.h>
 #include <sync.h>
@@ -11,15 +13,160 @@
 #include <txdb.h>
 #include <uint256.h>
 #include <util/fs.h>
+#include <util/thread.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <ios>
+#include <limits>
 #include <optional>
 #include <string>
 
 namespace node {
 
+SnapshotCoinsReader::SnapshotCoinsReader(AutoFile& file, uint64_t coins_count, int base_height)
+    : m_file{file},
+      m_coins_count{coins_count},
+      m_base_height{base_height},
+      m_thread{&util::TraceThread, "snapshotload", [this] { Read(); }}
+{
+}
+
+SnapshotCoinsReader::~SnapshotCoinsReader()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+std::optional<SnapshotCoinsReader::Batch> SnapshotCoinsReader::Next()
+{
+    std::optional<Batch> batch;
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_done || !m_batches.empty(); });
+        if (m_batches.empty()) return std::nullopt;
+        batch = std::move(m_batches.front());
+        m_batches.pop_front();
+    }
+    m_cv.notify_all();
+    return batch;
+}
+
+std::optional<uint256> SnapshotCoinsReader::GetHash() const
+{
+    return WITH_LOCK(m_mutex, return m_result);
+}
+
+bool SnapshotCoinsReader::Push(Batch&& batch)
+{
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_batches.size() < MAX_SNAPSHOT_BATCHES_AHEAD; });
+        if (m_stop) return false;
+        m_batches.push_back(std::move(batch));
+    }
+    m_cv.notify_all();
+    return true;
+}
+
+void SnapshotCoinsReader::Finish(std::optional<std::string> error)
+{
+    {
+        LOCK(m_mutex);
+        if (error) {
+            m_batches.push_back(Batch{.coins = {}, .error = std::move(error)});
+        } else if (m_in_order) {
+            m_result = m_hash.GetHash();
+        }
+        m_done = true;
+    }
+    m_cv.notify_all();
+}
+
+void SnapshotCoinsReader::HashTransaction(const Txid& txid, Span<const std::pair<COutPoint, Coin>> coins)
+{
+    if (coins.empty()) return;
+    // The coins database is ordered by txid first.
+    if (m_last_txid && !(*m_last_txid < txid)) m_in_order = false;
+    m_last_txid = txid;
+    if (!m_in_order) return;
+
+    // The coins of a transaction are hashed by increasing output index, which
+    // they usually are in already.
+    const auto not_increasing{[](const auto& a, const auto& b) { return a.first.n >= b.first.n; }};
+    if (std::adjacent_find(coins.begin(), coins.end(), not_increasing) == coins.end()) {
+        for (const auto& [outpoint, coin] : coins) {
+            kernel::ApplyCoinHash(m_hash, outpoint, coin);
+        }
+        return;
+    }
+    std::vector<std::pair<COutPoint, Coin>> sorted{coins.begin(), coins.end()};
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first.n < b.first.n; });
+    // Duplicate coins would only be added to the database once.
+    if (std::adjacent_find(sorted.begin(), sorted.end(), not_increasing) != sorted.end()) {
+        m_in_order = false;
+        return;
+    }
+    for (const auto& [outpoint, coin] : sorted) {
+        kernel::ApplyCoinHash(m_hash, outpoint, coin);
+    }
+}
+
+void SnapshotCoinsReader::Read()
+{
+    uint64_t coins_left{m_coins_count};
+    Batch batch;
+    try {
+        while (coins_left > 0) {
+            Txid txid;
+            m_file >> txid;
+            const size_t coins_per_txid{ReadCompactSize(m_file)};
+            if (coins_per_txid > coins_left) {
+                return Finish("Mismatch in coins count in snapshot metadata and actual snapshot data");
+            }
+
+            const size_t first_coin{batch.coins.size()};
+            for (size_t i = 0; i < coins_per_txid; i++) {
+                COutPoint outpoint;
+                Coin coin;
+                outpoint.n = static_cast<uint32_t>(ReadCompactSize(m_file));
+                outpoint.hash = txid;
+                m_file >> coin;
+                if (coin.nHeight > m_base_height ||
+                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                ) {
+                    return Finish(strprintf("Bad snapshot data after deserializing %d coins", m_coins_count - coins_left));
+                }
+                if (!MoneyRange(coin.out.nValue)) {
+                    return Finish(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value", m_coins_count - coins_left));
+                }
+                batch.coins.emplace_back(std::move(outpoint), std::move(coin));
+                --coins_left;
+            }
+            HashTransaction(txid, Span{batch.coins}.subspan(first_coin));
+
+            if (batch.coins.size() >= SNAPSHOT_BATCH_COINS || coins_left == 0) {
+                if (!Push(std::move(batch))) return;
+                batch = {};
+            }
+        }
+    } catch (const std::ios_base::failure&) {
+        return Finish(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins", m_coins_count - coins_left));
+    }
+
+    try {
+        std::byte left_over_byte;
+        m_file >> left_over_byte;
+    } catch (const std::ios_base::failure&) {
+        // We expect an exception since we should be out of coins.
+        return Finish(std::nullopt);
+    }
+    Finish(strprintf("Bad snapshot - coins left over after deserializing %d coins", m_coins_count));
+}
+
 bool WriteSnapshotBaseBlockhash(Chainstate& snapshot_chainstate)
 {
     AssertLockHeld(::cs_main);
@@ -7,22 +7,34 @@
 #define BITCOIN_NODE_UTXO_SNAPSHOT_H
 
 #include <chainparams.h>
+#include <coins.h>
+#include <hash.h>
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
+#include <primitives/transaction.h>
 #include <serialize.h>
 #include <sync.h>
+#include <threadsafety.h>
 #include <uint256.h>
 #include <util/chaintype.h>
 #include <util/check.h>
 #include <util/fs.h>
 
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // UTXO set snapshot magic bytes
 static constexpr std::array<uint8_t, 5> SNAPSHOT_MAGIC_BYTES = {'u', 't', 'x', 'o', 0xff};
 
+class AutoFile;
 class Chainstate;
 
 namespace node {
@@ -101,6 +113,67 @@ public:
     }
 };
 
+//! Number of coins read from a snapshot at once by SnapshotCoinsReader.
+static constexpr size_t SNAPSHOT_BATCH_COINS{10'000};
+//! Number of batches of coins that SnapshotCoinsReader reads ahead.
+static constexpr size_t MAX_SNAPSHOT_BATCHES_AHEAD{8};
+
+/**
+ * Reads the coins of a UTXO snapshot, which follow its metadata, on a separate
+ * thread, so that reading and parsing the file overlaps with adding the coins
+ * to the coins database.
+ *
+ * The HASH_SERIALIZED hash of the coins is computed as they are read. It is
+ * only the hash of the resulting coins database if the file lists the coins
+ * in database order, as dumptxoutset does.
+ */
+class SnapshotCoinsReader
+{
+public:
+    /** Coins read from the snapshot, in file order. */
+    struct Batch {
+        std::vector<std::pair<COutPoint, Coin>> coins;
+        //! Why the snapshot is bad, if it is. No batch follows this one then.
+        std::optional<std::string> error;
+    };
+
+    //! The file must not be used by the caller until the reader is destroyed.
+    SnapshotCoinsReader(AutoFile& file, uint64_t coins_count, int base_height);
+    ~SnapshotCoinsReader();
+
+    //! Wait for the next batch of coins, or return nullopt after the last one.
+    std::optional<Batch> Next() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! The HASH_SERIALIZED hash of the coins, once all were read without
+    //! error. Returns nullopt if the coins were not in database order.
+    std::optional<uint256> GetHash() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    AutoFile& m_file;
+    const uint64_t m_coins_count;
+    const int m_base_height;
+
+    //! Only used by the reading thread
+    HashWriter m_hash;
+    std::optional<Txid> m_last_txid;
+    bool m_in_order{true};
+
+    mutable Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Batch> m_batches GUARDED_BY(m_mutex);
+    //! Set once the reading thread added the last batch
+    bool m_done GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::optional<uint256> m_result GUARDED_BY(m_mutex);
+    std::thread m_thread;
+
+    void Read() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void HashTransaction(const Txid& txid, Span<const std::pair<COutPoint, Coin>> coins);
+    //! Add a batch, waiting while too many are read ahead. Returns false if the reader is being destroyed.
+    bool Push(Batch&& batch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Finish(std::optional<std::string> error) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
 //! The file in the snapshot chainstate dir which stores the base blockhash. This is
 //! needed to reconstruct snapshot chainstates on init.
 //!
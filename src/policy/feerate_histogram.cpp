@@ -0,0 +1,54 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/feerate_histogram.h>
+
+#include <util/check.h>
+
+#include <algorithm>
+
+size_t FeerateHistogram::BucketIndex(CAmount fee, int64_t vsize)
+{
+    if (fee <= 0 || vsize <= 0) return 0;
+    // First boundary the feerate is below, compared as fee < boundary * vsize
+    // to avoid rounding.
+    const auto it = std::upper_bound(BUCKET_BOUNDARIES.begin() + 1, BUCKET_BOUNDARIES.end(), fee,
+                                     [vsize](CAmount f, CAmount boundary) { return f < boundary * vsize; });
+    return (it - BUCKET_BOUNDARIES.begin()) - 1;
+}
+
+void FeerateHistogram::Add(size_t bucket, CAmount fee, int64_t vsize)
+{
+    Bucket& b{m_buckets.at(bucket)};
+    ++b.count;
+    b.vsize += vsize;
+    b.fees += fee;
+    ++m_total_count;
+    m_total_vsize += vsize;
+}
+
+void FeerateHistogram::Remove(size_t bucket, CAmount fee, int64_t vsize)
+{
+    Bucket& b{m_buckets.at(bucket)};
+    Assume(b.count > 0 && b.vsize >= vsize);
+    --b.count;
+    b.vsize -= vsize;
+    b.fees -= fee;
+    --m_total_count;
+    m_total_vsize -= vsize;
+}
+
+CFeeRate FeerateHistogram::GetPercentile(double percentile) const
+{
+    if (m_total_vsize == 0) return CFeeRate{};
+    const double target{std::clamp(percentile, 0.0, 100.0) * m_total_vsize / 100.0};
+    int64_t cumulative{0};
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        cumulative += m_buckets[i].vsize;
+        if (m_buckets[i].vsize > 0 && cumulative >= target) {
+            return CFeeRate{BUCKET_BOUNDARIES[i] * 1000};
+        }
+    }
+    return CFeeRate{BUCKET_BOUNDARIES.back() * 1000};
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POLICY_FEERATE_HISTOGRAM_H
+#define BITCOIN_POLICY_FEERATE_HISTOGRAM_H
+
+#include <consensus/amount.h>
+#include <policy/feerate.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Histogram of transactions by feerate, weighted by virtual size.
+ *
+ * Buckets have fixed boundaries so that the histogram can be updated in
+ * constant time as transactions enter and leave the mempool, or change bucket
+ * when their mining score changes. Reading it is independent of the number of
+ * transactions it describes.
+ */
+class FeerateHistogram
+{
+public:
+    /** Lower bound of each bucket, in sat/vB. The last bucket has no upper bound. */
+    static constexpr std::array<CAmount, 46> BUCKET_BOUNDARIES{
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 17, 20, 25, 30, 40, 50, 60, 70, 80, 100, 120,
+        140, 170, 200, 250, 300, 400, 500, 600, 700, 800, 1000, 1200, 1400, 1700, 2000, 2500,
+        3000, 4000, 5000, 6000, 7000, 8000, 10000};
+    static constexpr size_t NUM_BUCKETS{BUCKET_BOUNDARIES.size()};
+
+    struct Bucket {
+        /** Number of transactions in this bucket */
+        uint64_t count{0};
+        /** Sum of virtual sizes of transactions in this bucket */
+        int64_t vsize{0};
+        /** Sum of (unmodified) fees of transactions in this bucket */
+        CAmount fees{0};
+
+        bool operator==(const Bucket&) const = default;
+    };
+
+    /** Index of the bucket a transaction with the given fee and vsize falls into */
+    static size_t BucketIndex(CAmount fee, int64_t vsize);
+
+    void Add(size_t bucket, CAmount fee, int64_t vsize);
+    void Remove(size_t bucket, CAmount fee, int64_t vsize);
+
+    const std::array<Bucket, NUM_BUCKETS>& GetBuckets() const { return m_buckets; }
+    uint64_t GetTotalCount() const { return m_total_count; }
+    int64_t GetTotalVsize() const { return m_total_vsize; }
+
+    /**
+     * Feerate below which the given percentage of the total vsize is found,
+     * rounded down to the lower bound of the bucket it falls into.
+     * Returns a zero feerate for an empty histogram.
+     */
+    CFeeRate GetPercentile(double percentile) const;
+
+    bool operator==(const FeerateHistogram&) const = default;
+
+private:
+    std::array<Bucket, NUM_BUCKETS> m_buckets{};
+    uint64_t m_total_count{0};
+    int64_t m_total_vsize{0};
+};
+
+#endif // BITCOIN_POLICY_FEERATE_HISTOGRAM_H
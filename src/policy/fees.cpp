@@ -61,6 +61,26 @@ struct EncodedDoubleFormatter
     }
 };
 
+/** Convert a period-major table as stored in fee_estimates.dat to a flat array */
+std::vector<double> FlattenTable(const std::vector<std::vector<double>>& table)
+{
+    std::vector<double> flat;
+    for (const auto& row : table) {
+        flat.insert(flat.end(), row.begin(), row.end());
+    }
+    return flat;
+}
+
+/** Convert a flat period-major array back to the table format of fee_estimates.dat */
+std::vector<std::vector<double>> UnflattenTable(const std::vector<double>& flat, size_t row_size)
+{
+    std::vector<std::vector<double>> table;
+    for (auto it = flat.begin(); it != flat.end(); it += row_size) {
+        table.emplace_back(it, it + row_size);
+    }
+    return table;
+}
+
 } // namespace
 
 /**
@@ -78,6 +98,11 @@ private:
     const std::vector<double>& buckets;              // The upper-bound of the range for the bucket (inclusive)
     const std::map<double, unsigned int>& bucketMap; // Map of bucket upper-bound to index into all vectors by bucket
 
+    // The per-period tables below are stored as flat, period-major arrays so
+    // that the bucket row of each period is contiguous in memory.
+    size_t m_num_buckets;
+    size_t m_max_periods;
+
     // For each bucket X:
     // Count the total # of txs in each bucket
     // Track the historical moving average of this total over blocks
@@ -85,11 +110,11 @@ private:
 
     // Count the total # of txs confirmed within Y blocks in each bucket
     // Track the historical moving average of these totals over blocks
-    std::vector<std::vector<double>> confAvg; // confAvg[Y][X]
+    std::vector<double> confAvg; // confAvg[Y * m_num_buckets + X]
 
     // Track moving avg of txs which have been evicted from the mempool
     // after failing to be confirmed within Y blocks
-    std::vector<std::vector<double>> failAvg; // failAvg[Y][X]
+    std::vector<double> failAvg; // failAvg[Y * m_num_buckets + X]
 
     // Sum the total feerate of all tx's in each bucket
     // Track the historical moving average of this total over blocks
@@ -106,12 +131,21 @@ private:
     // Mempool counts of outstanding transactions
     // For each bucket X, track the number of transactions in the mempool
     // that are unconfirmed for each possible confirmation value Y
-    std::vector<std::vector<int> > unconfTxs;  //unconfTxs[Y][X]
+    std::vector<int> unconfTxs;  //unconfTxs[Y * m_num_buckets + X]
     // transactions still unconfirmed after GetMaxConfirms for each bucket
     std::vector<int> oldUnconfTxs;
+    // Sum of unconfTxs over all Y for each bucket X, so that estimates for
+    // short targets don't have to walk the whole circular buffer
+    std::vector<int> m_unconf_total;
+
+    size_t Index(size_t period, size_t bucket) const { return period * m_num_buckets + bucket; }
 
     void resizeInMemoryCounters(size_t newbuckets);
 
+    /** Number of transactions in a bucket that have been unconfirmed for at
+     * least confTarget blocks (including those older than GetMaxConfirms) */
+    int UnconfirmedAtLeast(unsigned int bucket, unsigned int confTarget, unsigned int nBlockHeight) const;
+
 public:
     /**
      * Create new TxConfirmStats. This is called by BlockPolicyEstimator's
@@ -159,7 +193,7 @@ public:
                              EstimationResult *result = nullptr) const;
 
     /** Return the max number of confirms we're tracking */
-    unsigned int GetMaxConfirms() const { return scale * confAvg.size(); }
+    unsigned int GetMaxConfirms() const { return scale * m_max_periods; }
 
     /** Write state of estimation data to a file*/
     void Write(AutoFile& fileout) const;
@@ -175,37 +209,34 @@ public:
 TxConfirmStats::TxConfirmStats(const std::vector<double>& defaultBuckets,
                                 const std::map<double, unsigned int>& defaultBucketMap,
                                unsigned int maxPeriods, double _decay, unsigned int _scale)
-    : buckets(defaultBuckets), bucketMap(defaultBucketMap), decay(_decay), scale(_scale)
+    : buckets(defaultBuckets), bucketMap(defaultBucketMap), m_num_buckets(defaultBuckets.size()), m_max_periods(maxPeriods), decay(_decay), scale(_scale)
 {
     assert(_scale != 0 && "_scale must be non-zero");
-    confAvg.resize(maxPeriods);
-    failAvg.resize(maxPeriods);
-    for (unsigned int i = 0; i < maxPeriods; i++) {
-        confAvg[i].resize(buckets.size());
-        failAvg[i].resize(buckets.size());
-    }
+    confAvg.resize(m_max_periods * m_num_buckets);
+    failAvg.resize(m_max_periods * m_num_buckets);
 
-    txCtAvg.resize(buckets.size());
-    m_feerate_avg.resize(buckets.size());
+    txCtAvg.resize(m_num_buckets);
+    m_feerate_avg.resize(m_num_buckets);
 
-    resizeInMemoryCounters(buckets.size());
+    resizeInMemoryCounters(m_num_buckets);
 }
 
 void TxConfirmStats::resizeInMemoryCounters(size_t newbuckets) {
     // newbuckets must be passed in because the buckets referred to during Read have not been updated yet.
-    unconfTxs.resize(GetMaxConfirms());
-    for (unsigned int i = 0; i < unconfTxs.size(); i++) {
-        unconfTxs[i].resize(newbuckets);
-    }
-    oldUnconfTxs.resize(newbuckets);
+    unconfTxs.assign(GetMaxConfirms() * newbuckets, 0);
+    oldUnconfTxs.assign(newbuckets, 0);
+    m_unconf_total.assign(newbuckets, 0);
 }
 
 // Roll the unconfirmed txs circular buffer
 void TxConfirmStats::ClearCurrent(unsigned int nBlockHeight)
 {
-    for (unsigned int j = 0; j < buckets.size(); j++) {
-        oldUnconfTxs[j] += unconfTxs[nBlockHeight % unconfTxs.size()][j];
-        unconfTxs[nBlockHeight%unconfTxs.size()][j] = 0;
+    const size_t blockIndex = nBlockHeight % GetMaxConfirms();
+    for (unsigned int j = 0; j < m_num_buckets; j++) {
+        int& current = unconfTxs[Index(blockIndex, j)];
+        oldUnconfTxs[j] += current;
+        m_unconf_total[j] -= current;
+        current = 0;
     }
 }
 
@@ -217,8 +248,8 @@ void TxConfirmStats::Record(int blocksToConfirm, double feerate)
         return;
     int periodsToConfirm = (blocksToConfirm + scale - 1) / scale;
     unsigned int bucketindex = bucketMap.lower_bound(feerate)->second;
-    for (size_t i = periodsToConfirm; i <= confAvg.size(); i++) {
-        confAvg[i - 1][bucketindex]++;
+    for (size_t i = periodsToConfirm; i <= m_max_periods; i++) {
+        confAvg[Index(i - 1, bucketindex)]++;
     }
     txCtAvg[bucketindex]++;
     m_feerate_avg[bucketindex] += feerate;
@@ -227,14 +258,30 @@ void TxConfirmStats::Record(int blocksToConfirm, double feerate)
 void TxConfirmStats::UpdateMovingAverages()
 {
     assert(confAvg.size() == failAvg.size());
-    for (unsigned int j = 0; j < buckets.size(); j++) {
-        for (unsigned int i = 0; i < confAvg.size(); i++) {
-            confAvg[i][j] *= decay;
-            failAvg[i][j] *= decay;
-        }
-        m_feerate_avg[j] *= decay;
-        txCtAvg[j] *= decay;
+    for (double& avg : confAvg) avg *= decay;
+    for (double& avg : failAvg) avg *= decay;
+    for (double& avg : m_feerate_avg) avg *= decay;
+    for (double& avg : txCtAvg) avg *= decay;
+}
+
+int TxConfirmStats::UnconfirmedAtLeast(unsigned int bucket, unsigned int confTarget, unsigned int nBlockHeight) const
+{
+    const unsigned int bins = GetMaxConfirms();
+    int count = oldUnconfTxs[bucket];
+    // Once the chain is at least as long as the circular buffer, the slots for
+    // confTarget..bins-1 blocks ago are exactly the ones outside the most
+    // recent confTarget slots, so walk whichever side is shorter. Before that
+    // the unsigned height arithmetic wraps, and only the direct walk gives the
+    // same answer as it always has.
+    if (nBlockHeight + 1 >= bins && 2 * confTarget < bins) {
+        count += m_unconf_total[bucket];
+        for (unsigned int confct = 0; confct < confTarget; confct++)
+            count -= unconfTxs[Index((nBlockHeight - confct) % bins, bucket)];
+    } else {
+        for (unsigned int confct = confTarget; confct < bins; confct++)
+            count += unconfTxs[Index((nBlockHeight - confct) % bins, bucket)];
     }
+    return count;
 }
 
 // returns -1 on error conditions
@@ -248,7 +295,9 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     int extraNum = 0;  // Number of tx's still in mempool for confTarget or longer
     double failNum = 0; // Number of tx's that were never confirmed but removed from the mempool after confTarget
     const int periodTarget = (confTarget + scale - 1) / scale;
-    const int maxbucketindex = buckets.size() - 1;
+    const int maxbucketindex = m_num_buckets - 1;
+    const double* const confRow = &confAvg[Index(periodTarget - 1, 0)];
+    const double* const failRow = &failAvg[Index(periodTarget - 1, 0)];
 
     // We'll combine buckets until we have enough samples.
     // The near and far variables will define the range we've combined
@@ -266,7 +315,6 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
     double partialNum = 0;
 
     bool foundAnswer = false;
-    unsigned int bins = unconfTxs.size();
     bool newBucketRange = true;
     bool passing = true;
     EstimatorBucket passBucket;
@@ -279,13 +327,11 @@ double TxConfirmStats::EstimateMedianVal(int confTarget, double sufficientTxVal,
             newBucketRange = false;
         }
         curFarBucket = bucket;
-        nConf += confAvg[periodTarget - 1][bucket];
+        nConf += confRow[bucket];
         partialNum += txCtAvg[bucket];
         totalNum += txCtAvg[bucket];
-        failNum += failAvg[periodTarget - 1][bucket];
-        for (unsigned int confct = confTarget; confct < GetMaxConfirms(); confct++)
-            extraNum += unconfTxs[(nBlockHeight - confct) % bins][bucket];
-        extraNum += oldUnconfTxs[bucket];
+        failNum += failRow[bucket];
+        extraNum += UnconfirmedAtLeast(bucket, confTarget, nBlockHeight);
         // If we have enough transaction data points in this range of buckets,
         // we can test for success
         // (Only count the confirmed data points, so that each confirmation count
@@ -410,8 +456,8 @@ void TxConfirmStats::Write(AutoFile& fileout) const
     fileout << scale;
     fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(m_feerate_avg);
     fileout << Using<VectorFormatter<EncodedDoubleFormatter>>(txCtAvg);
-    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(confAvg);
-    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(failAvg);
+    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(UnflattenTable(confAvg, m_num_buckets));
+    fileout << Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(UnflattenTable(failAvg, m_num_buckets));
 }
 
 void TxConfirmStats::Read(AutoFile& filein, int nFileVersion, size_t numBuckets)
@@ -439,29 +485,36 @@ void TxConfirmStats::Read(AutoFile& filein, int nFileVersion, size_t numBuckets)
     if (txCtAvg.size() != numBuckets) {
         throw std::runtime_error("Corrupt estimates file. Mismatch in tx count bucket count");
     }
-    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(confAvg);
-    maxPeriods = confAvg.size();
+    std::vector<std::vector<double>> fileConfAvg;
+    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(fileConfAvg);
+    maxPeriods = fileConfAvg.size();
     maxConfirms = scale * maxPeriods;
 
     if (maxConfirms <= 0 || maxConfirms > 6 * 24 * 7) { // one week
         throw std::runtime_error("Corrupt estimates file.  Must maintain estimates for between 1 and 1008 (one week) confirms");
     }
     for (unsigned int i = 0; i < maxPeriods; i++) {
-        if (confAvg[i].size() != numBuckets) {
+        if (fileConfAvg[i].size() != numBuckets) {
             throw std::runtime_error("Corrupt estimates file. Mismatch in feerate conf average bucket count");
         }
     }
 
-    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(failAvg);
-    if (maxPeriods != failAvg.size()) {
+    std::vector<std::vector<double>> fileFailAvg;
+    filein >> Using<VectorFormatter<VectorFormatter<EncodedDoubleFormatter>>>(fileFailAvg);
+    if (maxPeriods != fileFailAvg.size()) {
         throw std::runtime_error("Corrupt estimates file. Mismatch in confirms tracked for failures");
     }
     for (unsigned int i = 0; i < maxPeriods; i++) {
-        if (failAvg[i].size() != numBuckets) {
+        if (fileFailAvg[i].size() != numBuckets) {
             throw std::runtime_error("Corrupt estimates file. Mismatch in one of failure average bucket counts");
         }
     }
 
+    m_num_buckets = numBuckets;
+    m_max_periods = maxPeriods;
+    confAvg = FlattenTable(fileConfAvg);
+    failAvg = FlattenTable(fileFailAvg);
+
     // Resize the current block variables which aren't stored in the data file
     // to match the number of confirms and buckets
     resizeInMemoryCounters(numBuckets);
@@ -473,8 +526,9 @@ void TxConfirmStats::Read(AutoFile& filein, int nFileVersion, size_t numBuckets)
 unsigned int TxConfirmStats::NewTx(unsigned int nBlockHeight, double val)
 {
     unsigned int bucketindex = bucketMap.lower_bound(val)->second;
-    unsigned int blockIndex = nBlockHeight % unconfTxs.size();
-    unconfTxs[blockIndex][bucketindex]++;
+    unsigned int blockIndex = nBlockHeight % GetMaxConfirms();
+    unconfTxs[Index(blockIndex, bucketindex)]++;
+    m_unconf_total[bucketindex]++;
     return bucketindex;
 }
 
@@ -489,7 +543,7 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         return;  //This can't happen because we call this with our best seen height, no entries can have higher
     }
 
-    if (blocksAgo >= (int)unconfTxs.size()) {
+    if (blocksAgo >= (int)GetMaxConfirms()) {
         if (oldUnconfTxs[bucketindex] > 0) {
             oldUnconfTxs[bucketindex]--;
         } else {
@@ -498,9 +552,10 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
         }
     }
     else {
-        unsigned int blockIndex = entryHeight % unconfTxs.size();
-        if (unconfTxs[blockIndex][bucketindex] > 0) {
-            unconfTxs[blockIndex][bucketindex]--;
+        unsigned int blockIndex = entryHeight % GetMaxConfirms();
+        if (unconfTxs[Index(blockIndex, bucketindex)] > 0) {
+            unconfTxs[Index(blockIndex, bucketindex)]--;
+            m_unconf_total[bucketindex]--;
         } else {
             LogDebug(BCLog::ESTIMATEFEE, "Blockpolicy error, mempool tx removed from blockIndex=%u,bucketIndex=%u already\n",
                      blockIndex, bucketindex);
@@ -509,8 +564,8 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
     if (!inBlock && (unsigned int)blocksAgo >= scale) { // Only counts as a failure if not confirmed for entire period
         assert(scale != 0);
         unsigned int periodsAgo = blocksAgo / scale;
-        for (size_t i = 0; i < periodsAgo && i < failAvg.size(); i++) {
-            failAvg[i][bucketindex]++;
+        for (size_t i = 0; i < periodsAgo && i < m_max_periods; i++) {
+            failAvg[Index(i, bucketindex)]++;
         }
     }
 }
@@ -526,6 +581,7 @@ bool CBlockPolicyEstimator::_removeTx(const uint256& hash, bool inBlock)
     AssertLockHeld(m_cs_fee_estimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        if (UnconfirmedChangeAffectsEstimates(pos->second.blockHeight)) m_smart_fee_cache.clear();
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -536,6 +592,19 @@ bool CBlockPolicyEstimator::_removeTx(const uint256& hash, bool inBlock)
     }
 }
 
+bool CBlockPolicyEstimator::UnconfirmedChangeAffectsEstimates(unsigned int entry_height) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    // Transactions that entered the mempool at the current height are counted
+    // in a circular buffer slot that no target >= 1 looks at, unless the chain
+    // is still shorter than the buffer and the slot indices wrap around.
+    if (entry_height != nBestSeenHeight) return true;
+    for (const TxConfirmStats* stats : {feeStats.get(), shortStats.get(), longStats.get()}) {
+        if (nBestSeenHeight + 1 < stats->GetMaxConfirms()) return true;
+    }
+    return false;
+}
+
 CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath, const bool read_stale_estimates)
     : m_estimation_filepath{estimation_filepath}
 {
@@ -632,6 +701,8 @@ void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo&
     assert(bucketIndex == bucketIndex2);
     unsigned int bucketIndex3 = longStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
     assert(bucketIndex == bucketIndex3);
+
+    if (UnconfirmedChangeAffectsEstimates(txHeight)) m_smart_fee_cache.clear();
 }
 
 bool CBlockPolicyEstimator::processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx)
@@ -679,6 +750,7 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
     // calls to removeTx (via processBlockTx) correctly calculate age
     // of unconfirmed txs to remove from tracking.
     nBestSeenHeight = nBlockHeight;
+    m_smart_fee_cache.clear();
 
     // Update unconfirmed circular buffer
     feeStats->ClearCurrent(nBlockHeight);
@@ -868,10 +940,22 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
 {
     LOCK(m_cs_fee_estimator);
 
-    if (feeCalc) {
-        feeCalc->desiredTarget = confTarget;
-        feeCalc->returnedTarget = confTarget;
+    auto it = m_smart_fee_cache.find({confTarget, conservative});
+    if (it == m_smart_fee_cache.end()) {
+        FeeCalculation calc;
+        const CFeeRate feerate{_estimateSmartFee(confTarget, calc, conservative)};
+        it = m_smart_fee_cache.try_emplace({confTarget, conservative}, feerate, calc).first;
     }
+    if (feeCalc) *feeCalc = it->second.second;
+    return it->second.first;
+}
+
+CFeeRate CBlockPolicyEstimator::_estimateSmartFee(int confTarget, FeeCalculation& feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
+
+    feeCalc.desiredTarget = confTarget;
+    feeCalc.returnedTarget = confTarget;
 
     double median = -1;
     EstimationResult tempResult;
@@ -888,7 +972,7 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
     if ((unsigned int)confTarget > maxUsableEstimate) {
         confTarget = maxUsableEstimate;
     }
-    if (feeCalc) feeCalc->returnedTarget = confTarget;
+    feeCalc.returnedTarget = confTarget;
 
     if (confTarget <= 1) return CFeeRate(0); // error condition
 
@@ -904,36 +988,28 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
      * fluctuations lower our estimates by too much.
      */
     double halfEst = estimateCombinedFee(confTarget/2, HALF_SUCCESS_PCT, true, &tempResult);
-    if (feeCalc) {
-        feeCalc->est = tempResult;
-        feeCalc->reason = FeeReason::HALF_ESTIMATE;
-    }
+    feeCalc.est = tempResult;
+    feeCalc.reason = FeeReason::HALF_ESTIMATE;
     median = halfEst;
     double actualEst = estimateCombinedFee(confTarget, SUCCESS_PCT, true, &tempResult);
     if (actualEst > median) {
         median = actualEst;
-        if (feeCalc) {
-            feeCalc->est = tempResult;
-            feeCalc->reason = FeeReason::FULL_ESTIMATE;
-        }
+        feeCalc.est = tempResult;
+        feeCalc.reason = FeeReason::FULL_ESTIMATE;
     }
     double doubleEst = estimateCombinedFee(2 * confTarget, DOUBLE_SUCCESS_PCT, !conservative, &tempResult);
     if (doubleEst > median) {
         median = doubleEst;
-        if (feeCalc) {
-            feeCalc->est = tempResult;
-            feeCalc->reason = FeeReason::DOUBLE_ESTIMATE;
-        }
+        feeCalc.est = tempResult;
+        feeCalc.reason = FeeReason::DOUBLE_ESTIMATE;
     }
 
     if (conservative || median == -1) {
         double consEst =  estimateConservativeFee(2 * confTarget, &tempResult);
         if (consEst > median) {
             median = consEst;
-            if (feeCalc) {
-                feeCalc->est = tempResult;
-                feeCalc->reason = FeeReason::CONSERVATIVE;
-            }
+            feeCalc.est = tempResult;
+            feeCalc.reason = FeeReason::CONSERVATIVE;
         }
     }
 
@@ -1035,6 +1111,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            m_smart_fee_cache.clear();
         }
     }
     catch (const std::exception& e) {
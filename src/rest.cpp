@@ -14,6 +14,7 @@
 #include <flatfile.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/scriptindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -530,8 +531,8 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
 
     bool index_ready = index->BlockUntilSyncedToCurrentChain();
 
-    BlockFilter filter;
-    if (!index->LookupFilter(block_index, filter)) {
+    EncodedBlockFilter filter;
+    if (!index->LookupEncodedFilter(block_index, filter)) {
         std::string errmsg = "Filter not found.";
 
         if (!block_was_connected) {
@@ -565,7 +566,7 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
     }
     case RESTResponseFormat::JSON: {
         UniValue ret(UniValue::VOBJ);
-        ret.pushKV("filter", HexStr(filter.GetEncodedFilter()));
+        ret.pushKV("filter", HexStr(*filter.encoded_filter));
         std::string strJSON = ret.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
@@ -653,8 +654,8 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
 
     std::string param;
     const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
-    if (param != "contents" && param != "info") {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents>.json");
+    if (param != "contents" && param != "info" && param != "feehistogram" && param != "events") {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents|feehistogram|events>.json");
     }
 
     const CTxMemPool* mempool = GetMemPool(context, req);
@@ -688,6 +689,24 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
             str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+        } else if (param == "feehistogram") {
+            str_json = MempoolFeeHistogramToJSON(*mempool).write() + "\n";
+        } else if (param == "events") {
+            std::string raw_sequence;
+            try {
+                raw_sequence = req->GetQueryParameter("sequence").value_or("");
+            } catch (const std::runtime_error& e) {
+                return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+            }
+            const auto sequence{ToIntegral<uint64_t>(raw_sequence)};
+            if (!sequence) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "The \"sequence\" query parameter must be a non-negative integer.");
+            }
+            const auto events{MempoolEventsToJSON(*mempool, *sequence)};
+            if (!events) {
+                return RESTERR(req, HTTP_NOT_FOUND, strprintf("Mempool events since sequence %d are not available", *sequence));
+            }
+            str_json = events->write() + "\n";
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
         }
@@ -702,6 +721,65 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
     }
 }
 
+static bool rest_script_history(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string script_hex;
+    const RESTResponseFormat rf = ParseDataFormat(script_hex, str_uri_part);
+
+    const auto script_bytes{TryParseHex<uint8_t>(script_hex)};
+    if (!script_bytes) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid scriptPubKey: " + script_hex);
+    }
+    const CScript script(script_bytes->begin(), script_bytes->end());
+
+    size_t count{DEFAULT_SCRIPT_HISTORY_COUNT};
+    std::optional<ScriptHistoryPosition> after;
+    try {
+        if (const auto raw_count{req->GetQueryParameter("count")}) {
+            const auto count_param{ToIntegral<size_t>(*raw_count)};
+            if (!count_param || *count_param < 1 || *count_param > MAX_SCRIPT_HISTORY_COUNT) {
+                return RESTERR(req, HTTP_BAD_REQUEST, strprintf("The \"count\" query parameter must be an integer between 1 and %d.", MAX_SCRIPT_HISTORY_COUNT));
+            }
+            count = *count_param;
+        }
+        if (const auto raw_after{req->GetQueryParameter("after")}) {
+            after = ParseScriptHistoryCursor(*raw_after);
+            if (!after) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "Invalid \"after\" cursor: " + *raw_after);
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
+    if (!g_script_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Script index is not enabled");
+    }
+    if (!g_script_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Script index is still in the process of being built");
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        const auto history{ScriptHistoryToJSON(*maybe_chainman, *g_script_index, script, after, count)};
+        if (!history) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read script index");
+        }
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, history->write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -869,11 +947,12 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
     uint256 active_hash;
     {
         auto process_utxos = [&vOutPoints, &outs, &hits, &active_height, &active_hash, &chainman](const CCoinsView& view, const CTxMemPool* mempool) EXCLUSIVE_LOCKS_REQUIRED(chainman.GetMutex()) {
-            for (const COutPoint& vOutPoint : vOutPoints) {
-                Coin coin;
-                bool hit = (!mempool || !mempool->isSpent(vOutPoint)) && view.GetCoin(vOutPoint, coin);
+            std::vector<std::optional<Coin>> coins;
+            view.GetCoins(vOutPoints, coins);
+            for (size_t i = 0; i < vOutPoints.size(); ++i) {
+                bool hit = (!mempool || !mempool->isSpent(vOutPoints[i])) && coins[i];
                 hits.push_back(hit);
-                if (hit) outs.emplace_back(std::move(coin));
+                if (hit) outs.emplace_back(std::move(*coins[i]));
             }
             active_height = chainman.ActiveHeight();
             active_hash = chainman.ActiveTip()->GetBlockHash();
@@ -1017,6 +1096,7 @@ static const struct {
       {"/rest/blockfilterheaders/", rest_filter_header},
       {"/rest/chaininfo", rest_chaininfo},
       {"/rest/mempool/", rest_mempool},
+      {"/rest/scripthistory/", rest_script_history},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/deploymentinfo/", rest_deploymentinfo},
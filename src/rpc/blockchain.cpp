@@ -12,16 +12,19 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <dbwrapper.h>
 #include <deploymentinfo.h>
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
@@ -46,6 +49,7 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -53,10 +57,14 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <condition_variable>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
+#include <vector>
 
 using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
@@ -908,6 +916,9 @@ CoinStatsHashType ParseHashType(const std::string& hash_type_input)
     }
 }
 
+/** Maximum number of threads computing UTXO set statistics */
+static constexpr int MAX_UTXO_STATS_THREADS{8};
+
 /**
  * Calculate statistics about the unspent transaction output set
  *
@@ -935,7 +946,19 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view->GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    // Computing the statistics of a large UTXO set takes a while, so log the
+    // progress every 10%.
+    int logged_percent{0};
+    const kernel::UTXOStatsOptions options{
+        .threads = std::clamp(GetNumCores(), 1, MAX_UTXO_STATS_THREADS),
+        .progress = [&](double progress) {
+            const int percent{static_cast<int>(progress * 10) * 10};
+            if (percent <= logged_percent) return;
+            logged_percent = percent;
+            LogPrintf("Computing UTXO set statistics: %d%%\n", percent);
+        },
+    };
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point, options);
 }
 
 static RPCHelpMan gettxoutsetinfo()
@@ -2407,6 +2430,56 @@ static bool CheckBlockFilterMatches(BlockManager& blockman, const CBlockIndex& b
     return false;
 }
 
+/** Maximum number of threads matching block filters in scanblocks */
+static constexpr int MAX_SCANBLOCKS_THREADS{8};
+/** Minimum number of filters per thread matching block filters in scanblocks */
+static constexpr size_t MIN_SCANBLOCKS_FILTERS_PER_THREAD{100};
+
+/** Match the needles against each filter, splitting the filters between several threads. */
+static std::vector<uint8_t> MatchBlockFilters(const std::vector<BlockFilter>& filters, const GCSFilter::ElementSet& needles)
+{
+    std::vector<uint8_t> matches(filters.size());
+    const auto match_range{[&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            matches[i] = filters[i].GetFilter().MatchAny(needles);
+        }
+    }};
+
+    const size_t num_threads{std::min<size_t>({size_t(std::max(GetNumCores(), 1)), size_t{MAX_SCANBLOCKS_THREADS},
+                                               filters.size() / MIN_SCANBLOCKS_FILTERS_PER_THREAD})};
+    if (num_threads <= 1) {
+        match_range(0, filters.size());
+        return matches;
+    }
+
+    // Filters are split in contiguous slices, the last one is matched on this thread.
+    const size_t slice_size{(filters.size() + num_threads - 1) / num_threads};
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t t = 0; t < num_threads; ++t) {
+        const size_t begin{std::min(t * slice_size, filters.size())};
+        const size_t end{std::min(begin + slice_size, filters.size())};
+        const auto run{[&, t, begin, end] {
+            try {
+                match_range(begin, end);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        }};
+        if (t + 1 < num_threads) {
+            threads.emplace_back(run);
+        } else {
+            run();
+        }
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return matches;
+}
+
 static RPCHelpMan scanblocks()
 {
     return RPCHelpMan{"scanblocks",
@@ -2552,9 +2625,11 @@ static RPCHelpMan scanblocks()
                     stop_block;
 
             if (index->LookupFilterRange(start_block, end_range, filters)) {
-                for (const BlockFilter& filter : filters) {
-                    // compare the elements-set with each filter
-                    if (filter.GetFilter().MatchAny(needle_set)) {
+                // compare the elements-set with each filter
+                const std::vector<uint8_t> matches{MatchBlockFilters(filters, needle_set)};
+                for (size_t i = 0; i < filters.size(); ++i) {
+                    const BlockFilter& filter{filters[i]};
+                    if (matches[i]) {
                         if (filter_false_positives) {
                             // Double check the filter matches by scanning the block
                             const CBlockIndex& blockindex = *CHECK_NONFATAL(WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(filter.GetBlockHash())));
@@ -2674,6 +2749,139 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+std::optional<ScriptHistoryPosition> ParseScriptHistoryCursor(const std::string& cursor)
+{
+    const auto bytes{TryParseHex<uint8_t>(cursor)};
+    if (!bytes || bytes->size() != 13) return std::nullopt;
+    ScriptHistoryPosition pos;
+    SpanReader{*bytes} >> pos;
+    return pos;
+}
+
+std::optional<UniValue> ScriptHistoryToJSON(ChainstateManager& chainman, const ScriptIndex& index, const CScript& script,
+                                            const std::optional<ScriptHistoryPosition>& after, size_t count)
+{
+    // Look up one more entry than requested to know whether there is a next page
+    std::vector<ScriptHistoryEntry> entries;
+    if (!index.LookupHistory(script, after, count + 1, entries)) {
+        return std::nullopt;
+    }
+    const bool has_next{entries.size() > count};
+    if (has_next) entries.resize(count);
+
+    UniValue history(UniValue::VARR);
+    {
+        LOCK(cs_main);
+        const CChain& active_chain{chainman.ActiveChain()};
+        for (const ScriptHistoryEntry& entry : entries) {
+            UniValue obj(UniValue::VOBJ);
+            obj.pushKV("type", entry.pos.spending ? "spending" : "funding");
+            obj.pushKV("height", entry.pos.height);
+            if (const CBlockIndex* block_index{active_chain[entry.pos.height]}) {
+                obj.pushKV("blockhash", block_index->GetBlockHash().GetHex());
+            }
+            obj.pushKV("txid", entry.txid.GetHex());
+            if (entry.pos.spending) {
+                obj.pushKV("vin", entry.pos.index);
+                UniValue prevout(UniValue::VOBJ);
+                prevout.pushKV("txid", entry.prevout.hash.GetHex());
+                prevout.pushKV("vout", entry.prevout.n);
+                obj.pushKV("prevout", std::move(prevout));
+            } else {
+                obj.pushKV("vout", entry.pos.index);
+            }
+            obj.pushKV("amount", ValueFromAmount(entry.amount));
+            history.push_back(std::move(obj));
+        }
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("history", std::move(history));
+    if (has_next) {
+        DataStream cursor;
+        cursor << entries.back().pos;
+        ret.pushKV("next", HexStr(cursor));
+    }
+    return ret;
+}
+
+static RPCHelpMan getscripthistory()
+{
+    return RPCHelpMan{"getscripthistory",
+                "\nReturn the confirmed transaction outputs funding a scriptPubKey and the inputs spending from it, in chain order (requires -scriptindex).\n"
+                "Long histories are returned in pages: pass the \"next\" cursor of a page as \"after\" to get the following one.\n"
+                "Scripts are identified by a short hash, so in rare cases entries of another script may be included.\n",
+                {
+                    {"scriptpubkey", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The hex-encoded scriptPubKey"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_SCRIPT_HISTORY_COUNT}, strprintf("The maximum number of entries to return, at most %d", MAX_SCRIPT_HISTORY_COUNT)},
+                    {"after", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "Only return entries after this cursor, as returned in \"next\" by a previous call"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "history", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR, "type", "\"funding\" for an output paying to the script, \"spending\" for an input spending from it"},
+                                {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                                {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "The hash of the block containing the transaction, omitted if it was just disconnected"},
+                                {RPCResult::Type::STR_HEX, "txid", "The funding or spending transaction id"},
+                                {RPCResult::Type::NUM, "vout", /*optional=*/true, "The output index, for funding entries"},
+                                {RPCResult::Type::NUM, "vin", /*optional=*/true, "The input index, for spending entries"},
+                                {RPCResult::Type::OBJ, "prevout", /*optional=*/true, "The spent output, for spending entries",
+                                {
+                                    {RPCResult::Type::STR_HEX, "txid", "The transaction id of the spent output"},
+                                    {RPCResult::Type::NUM, "vout", "The index of the spent output"},
+                                }},
+                                {RPCResult::Type::STR_AMOUNT, "amount", "The amount of the output in " + CURRENCY_UNIT},
+                            }},
+                        }},
+                        {RPCResult::Type::STR_HEX, "next", /*optional=*/true, "The cursor to pass as \"after\" to get the next page, omitted on the last page"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\"") +
+                    HelpExampleCli("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\" 100 \"000000c80000000100000000000\"") +
+                    HelpExampleRpc("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\", 100")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::vector<unsigned char> script_bytes{ParseHexV(request.params[0], "scriptpubkey")};
+    const CScript script(script_bytes.begin(), script_bytes.end());
+
+    size_t count{DEFAULT_SCRIPT_HISTORY_COUNT};
+    if (!request.params[1].isNull()) {
+        const int count_param{request.params[1].getInt<int>()};
+        if (count_param < 1 || static_cast<size_t>(count_param) > MAX_SCRIPT_HISTORY_COUNT) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid count, must be between 1 and %d", MAX_SCRIPT_HISTORY_COUNT));
+        }
+        count = count_param;
+    }
+
+    std::optional<ScriptHistoryPosition> after;
+    if (!request.params[2].isNull()) {
+        after = ParseScriptHistoryCursor(request.params[2].get_str());
+        if (!after) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid after cursor");
+        }
+    }
+
+    if (!g_script_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Script index is not enabled, use -scriptindex");
+    }
+    if (!g_script_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Script index is still in the process of being built");
+    }
+
+    auto ret{ScriptHistoryToJSON(EnsureAnyChainman(request.context), *g_script_index, script, after, count)};
+    if (!ret) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read script index. This error is unexpected and indicates index corruption.");
+    }
+    return *ret;
+},
+    };
+}
+
 /**
  * RAII class that disables the network in its constructor and enables it in its
  * destructor.
@@ -3139,6 +3347,67 @@ return RPCHelpMan{
     };
 }
 
+static UniValue CompactionStatsToJSON(const DBCompactionStats& stats)
+{
+    UniValue levels(UniValue::VARR);
+    for (const auto& level : stats.levels) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("files", level.files);
+        obj.pushKV("bytes", level.bytes);
+        obj.pushKV("compaction_time", Ticks<std::chrono::seconds>(level.compaction_time));
+        obj.pushKV("bytes_read", level.bytes_read);
+        obj.pushKV("bytes_written", level.bytes_written);
+        levels.push_back(std::move(obj));
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("levels", std::move(levels));
+    result.pushKV("pending_bytes", stats.pending_bytes);
+    result.pushKV("stall_time", Ticks<SecondsDouble>(stats.stall_time));
+    return result;
+}
+
+static RPCHelpMan getcompactionstats()
+{
+    const std::vector<RPCResult> db_stats_doc{
+        {RPCResult::Type::ARR, "levels", "the LevelDB levels, from level 0 up",
+        {
+            {RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "files", "the number of table files in the level"},
+                {RPCResult::Type::NUM, "bytes", "the size of the table files in the level"},
+                {RPCResult::Type::NUM, "compaction_time", "the time spent compacting into the level, in whole seconds"},
+                {RPCResult::Type::NUM, "bytes_read", "the bytes read by compactions into the level, rounded to whole MiB"},
+                {RPCResult::Type::NUM, "bytes_written", "the bytes written by compactions into the level, rounded to whole MiB"},
+            }},
+        }},
+        {RPCResult::Type::NUM, "pending_bytes", "an estimate of the data yet to be compacted for the levels to fit their target sizes"},
+        {RPCResult::Type::NUM, "stall_time", "the time in seconds spent in writes slowed down or stalled by pending compactions"},
+    };
+    return RPCHelpMan{
+        "getcompactionstats",
+        "\nReturn statistics about the compactions of the chainstate and block index databases since startup.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::OBJ, "chainstate", "the database of the active chainstate", db_stats_doc},
+                {RPCResult::Type::OBJ, "blockindex", "the block index database", db_stats_doc},
+            }},
+        RPCExamples{
+            HelpExampleCli("getcompactionstats", "")
+            + HelpExampleRpc("getcompactionstats", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("chainstate", CompactionStatsToJSON(chainman.ActiveChainstate().CoinsDB().GetCompactionStats()));
+    result.pushKV("blockindex", CompactionStatsToJSON(chainman.m_blockman.m_block_tree_db->GetCompactionStats()));
+    return result;
+},
+    };
+}
 
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
@@ -3163,9 +3432,11 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getscripthistory},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &getcompactionstats},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
@@ -13,13 +13,18 @@
 #include <validation.h>
 
 #include <any>
+#include <optional>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class CScript;
+class ScriptIndex;
 class UniValue;
+struct ScriptHistoryPosition;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -27,6 +32,10 @@ struct NodeContext;
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
 
+/** Default and maximum number of entries in a page of script history */
+static constexpr size_t DEFAULT_SCRIPT_HISTORY_COUNT{100};
+static constexpr size_t MAX_SCRIPT_HISTORY_COUNT{1000};
+
 /**
  * Get the difficulty of the net wrt to the given block index.
  *
@@ -58,6 +67,16 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath);
 
+/** Parse the "next" cursor of a page of script history */
+std::optional<ScriptHistoryPosition> ParseScriptHistoryCursor(const std::string& cursor);
+
+/**
+ * Look up a page of the history of a script in the script index.
+ * @return the entries and the cursor of the next page if any, or std::nullopt if the index could not be read.
+ */
+std::optional<UniValue> ScriptHistoryToJSON(ChainstateManager& chainman, const ScriptIndex& index, const CScript& script,
+                                            const std::optional<ScriptHistoryPosition>& after, size_t count) LOCKS_EXCLUDED(cs_main);
+
 //! Return height of highest block that has been pruned, or std::nullopt if no blocks have been pruned
 std::optional<int> GetPruneHeight(const node::BlockManager& blockman, const CChain& chain) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 void CheckBlockDataAvailability(node::BlockManager& blockman, const CBlockIndex& blockindex, bool check_for_undo) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
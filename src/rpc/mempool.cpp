@@ -4,15 +4,18 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <rpc/blockchain.h>
+#include <rpc/mempool.h>
 
 #include <node/mempool_persist.h>
 
+#include <chain.h>
 #include <chainparams.h>
 #include <core_io.h>
+#include <index/txospenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <node/mempool_persist_args.h>
 #include <node/types.h>
-#include <policy/rbf.h>
+#include <policy/feerate_histogram.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
@@ -25,6 +28,7 @@
 #include <util/strencodings.h>
 #include <util/time.h>
 
+#include <optional>
 #include <utility>
 
 using node::DumpMempool;
@@ -279,33 +283,28 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+static void entryToJSON(UniValue& info, const MempoolSnapshot::Entry& e)
 {
-    AssertLockHeld(pool.cs);
-
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    info.pushKV("vsize", (int)e.vsize);
+    info.pushKV("weight", (int)e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.count_with_descendants);
+    info.pushKV("descendantsize", e.size_with_descendants);
+    info.pushKV("ancestorcount", e.count_with_ancestors);
+    info.pushKV("ancestorsize", e.size_with_ancestors);
+    info.pushKV("wtxid", e.tx->GetWitnessHash().ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.mod_fees_with_ancestors));
+    fees.pushKV("descendant", ValueFromAmount(e.mod_fees_with_descendants));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(GenTxid::Txid(txin.prevout.hash)))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : e.parents) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -317,23 +316,13 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.children) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
-
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
-    }
-
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+    info.pushKV("bip125-replaceable", e.bip125_replaceable);
+    info.pushKV("unbroadcast", e.unbroadcast);
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -342,33 +331,29 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
+        const auto snapshot{pool.GetSnapshot()};
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        for (const MempoolSnapshot::Entry& e : snapshot->entries) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
+            entryToJSON(info, e);
             // Mempool has unique entries so there is no advantage in using
             // UniValue::pushKV, which checks if the key already exists in O(N).
             // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+            o.pushKVEnd(e.tx->GetHash().ToString(), std::move(info));
         }
         return o;
     } else {
+        const auto snapshot{pool.GetSnapshot()};
         UniValue a(UniValue::VARR);
-        uint64_t mempool_sequence;
-        {
-            LOCK(pool.cs);
-            for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
-            }
-            mempool_sequence = pool.GetSequence();
+        for (const MempoolSnapshot::Entry& e : snapshot->entries) {
+            a.push_back(e.tx->GetHash().ToString());
         }
         if (!include_mempool_sequence) {
             return a;
         } else {
             UniValue o(UniValue::VOBJ);
             o.pushKV("txids", std::move(a));
-            o.pushKV("mempool_sequence", mempool_sequence);
+            o.pushKV("mempool_sequence", snapshot->sequence);
             return o;
         }
     }
@@ -476,7 +461,7 @@ static RPCHelpMan getmempoolancestors()
             const CTxMemPoolEntry &e = *ancestorIt;
             const uint256& _hash = e.GetTx().GetHash();
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
+            entryToJSON(info, mempool.MakeSnapshotEntry(e));
             o.pushKV(_hash.ToString(), std::move(info));
         }
         return o;
@@ -541,7 +526,7 @@ static RPCHelpMan getmempooldescendants()
             const CTxMemPoolEntry &e = *descendantIt;
             const uint256& _hash = e.GetTx().GetHash();
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
+            entryToJSON(info, mempool.MakeSnapshotEntry(e));
             o.pushKV(_hash.ToString(), std::move(info));
         }
         return o;
@@ -568,24 +553,51 @@ static RPCHelpMan getmempoolentry()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
-
-    const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
-    if (entry == nullptr) {
+    const auto entry{mempool.GetSnapshotEntry(Txid::FromUint256(hash))};
+    if (!entry) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
     }
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(info, *entry);
     return info;
 },
     };
 }
 
+/** Add the confirmed spending transactions of outputs not spent in the mempool to their result objects */
+static void AddConfirmedSpenders(ChainstateManager& chainman, const std::vector<std::pair<size_t, COutPoint>>& prevouts, std::vector<UniValue>& outputs)
+{
+    if (!g_txospender_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Mempool lacks a relevant spend, and -txospenderindex is not enabled");
+    }
+    if (!g_txospender_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Mempool lacks a relevant spend, and -txospenderindex is still in the process of being built");
+    }
+
+    std::vector<std::pair<size_t, TxoSpender>> spenders;
+    for (const auto& [pos, prevout] : prevouts) {
+        if (const auto spender{g_txospender_index->FindSpender(prevout)}) {
+            spenders.emplace_back(pos, *spender);
+        }
+    }
+
+    LOCK(cs_main);
+    const CChain& active_chain{chainman.ActiveChain()};
+    for (const auto& [pos, spender] : spenders) {
+        UniValue& o{outputs.at(pos)};
+        o.pushKV("spendingtxid", spender.txid.ToString());
+        if (const CBlockIndex* block_index{active_chain[spender.height]}) {
+            o.pushKV("blockhash", block_index->GetBlockHash().GetHex());
+        }
+    }
+}
+
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool to find transactions spending any of the given outputs.\n"
+        "Outputs not spent in the mempool are looked up in the block chain if -txospenderindex is enabled.",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -597,6 +609,11 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true if -txospenderindex is not enabled"}, "Only look for spending transactions in the mempool"},
+                },
+            },
         },
         RPCResult{
             RPCResult::Type::ARR, "", "",
@@ -605,7 +622,8 @@ static RPCHelpMan gettxspendingprevout()
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the hash of the block containing the spending transaction (omitted if spent in the mempool or unspent)"},
                 }},
             }
         },
@@ -641,24 +659,41 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
-            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-            LOCK(mempool.cs);
+            const UniValue& options{request.params[1]};
+            const bool mempool_only{options.exists("mempool_only") ? options["mempool_only"].get_bool() : !g_txospender_index};
 
-            UniValue result{UniValue::VARR};
+            // Outputs not spent in the mempool, by position in the result
+            std::vector<std::pair<size_t, COutPoint>> unspent_in_mempool;
+            std::vector<UniValue> outputs;
+            outputs.reserve(prevouts.size());
+            {
+                const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+                LOCK(mempool.cs);
 
-            for (const COutPoint& prevout : prevouts) {
-                UniValue o(UniValue::VOBJ);
-                o.pushKV("txid", prevout.hash.ToString());
-                o.pushKV("vout", (uint64_t)prevout.n);
+                for (const COutPoint& prevout : prevouts) {
+                    UniValue o(UniValue::VOBJ);
+                    o.pushKV("txid", prevout.hash.ToString());
+                    o.pushKV("vout", (uint64_t)prevout.n);
 
-                const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
-                if (spendingTx != nullptr) {
-                    o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                    const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
+                    if (spendingTx != nullptr) {
+                        o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                    } else {
+                        unspent_in_mempool.emplace_back(outputs.size(), prevout);
+                    }
+
+                    outputs.push_back(std::move(o));
                 }
+            }
 
-                result.push_back(std::move(o));
+            if (!mempool_only && !unspent_in_mempool.empty()) {
+                AddConfirmedSpenders(EnsureAnyChainman(request.context), unspent_in_mempool, outputs);
             }
 
+            UniValue result{UniValue::VARR};
+            for (UniValue& o : outputs) {
+                result.push_back(std::move(o));
+            }
             return result;
         },
     };
@@ -714,6 +749,178 @@ static RPCHelpMan getmempoolinfo()
     };
 }
 
+UniValue MempoolFeeHistogramToJSON(const CTxMemPool& pool, const std::vector<double>& percentiles)
+{
+    // Copy the histogram so the lock is only held for a constant amount of time.
+    FeerateHistogram histogram;
+    UniValue ret(UniValue::VOBJ);
+    {
+        LOCK(pool.cs);
+        histogram = pool.GetFeerateHistogram();
+        ret.pushKV("size", (int64_t)pool.size());
+        ret.pushKV("bytes", (int64_t)pool.GetTotalTxSize());
+        ret.pushKV("total_fee", ValueFromAmount(pool.GetTotalFee()));
+    }
+
+    UniValue percentiles_json(UniValue::VARR);
+    for (const double percentile : percentiles) {
+        UniValue p(UniValue::VOBJ);
+        p.pushKV("percentile", percentile);
+        p.pushKV("feerate", histogram.GetPercentile(percentile).GetFeePerK() / 1000);
+        percentiles_json.push_back(std::move(p));
+    }
+    ret.pushKV("percentiles", std::move(percentiles_json));
+
+    UniValue buckets(UniValue::VARR);
+    for (size_t i = 0; i < FeerateHistogram::NUM_BUCKETS; ++i) {
+        const FeerateHistogram::Bucket& bucket{histogram.GetBuckets()[i]};
+        UniValue b(UniValue::VOBJ);
+        b.pushKV("feerate_from", FeerateHistogram::BUCKET_BOUNDARIES[i]);
+        if (i + 1 < FeerateHistogram::NUM_BUCKETS) {
+            b.pushKV("feerate_to", FeerateHistogram::BUCKET_BOUNDARIES[i + 1]);
+        }
+        b.pushKV("count", bucket.count);
+        b.pushKV("vsize", bucket.vsize);
+        b.pushKV("fees", ValueFromAmount(bucket.fees));
+        buckets.push_back(std::move(b));
+    }
+    ret.pushKV("fee_histogram", std::move(buckets));
+    return ret;
+}
+
+static RPCHelpMan getmempoolfeehistogram()
+{
+    return RPCHelpMan{"getmempoolfeehistogram",
+        "Returns a histogram of the virtual size of mempool transactions by ancestor feerate, and feerate percentiles derived from it.\n"
+        "The histogram is maintained incrementally by the mempool, so the cost of this call does not depend on the mempool size.\n"
+        "A transaction is counted at the lower of its own and its ancestor package's feerate, including prioritisation.\n",
+        {
+            {"percentiles", RPCArg::Type::ARR, RPCArg::DefaultHint{"[5, 10, 25, 50, 75, 90, 95]"}, "The percentiles of mempool virtual size to report feerates for.",
+                {
+                    {"percentile", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "A percentile between 0 and 100"},
+                },
+            },
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "size", "Current tx count"},
+                {RPCResult::Type::NUM, "bytes", "Sum of all virtual transaction sizes as defined in BIP 141"},
+                {RPCResult::Type::STR_AMOUNT, "total_fee", "Total fees for the mempool in " + CURRENCY_UNIT + ", ignoring modified fees through prioritisetransaction"},
+                {RPCResult::Type::ARR, "percentiles", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "percentile", "The requested percentile"},
+                        {RPCResult::Type::NUM, "feerate", "Lower bound in " + CURRENCY_ATOM + "/vB of the histogram bucket below which this percentile of the mempool virtual size is found"},
+                    }},
+                }},
+                {RPCResult::Type::ARR, "fee_histogram", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "feerate_from", "Inclusive lower bound of the bucket in " + CURRENCY_ATOM + "/vB"},
+                        {RPCResult::Type::NUM, "feerate_to", /*optional=*/true, "Exclusive upper bound of the bucket in " + CURRENCY_ATOM + "/vB (omitted for the last bucket)"},
+                        {RPCResult::Type::NUM, "count", "Number of transactions in the bucket"},
+                        {RPCResult::Type::NUM, "vsize", "Sum of the virtual sizes of transactions in the bucket"},
+                        {RPCResult::Type::STR_AMOUNT, "fees", "Sum of the fees of transactions in the bucket in " + CURRENCY_UNIT + ", ignoring modified fees through prioritisetransaction"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getmempoolfeehistogram", "")
+            + HelpExampleCli("getmempoolfeehistogram", "\"[50, 90]\"")
+            + HelpExampleRpc("getmempoolfeehistogram", "[50, 90]")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::vector<double> percentiles{DEFAULT_FEE_HISTOGRAM_PERCENTILES};
+    if (!request.params[0].isNull()) {
+        percentiles.clear();
+        for (const UniValue& p : request.params[0].get_array().getValues()) {
+            const double percentile{p.get_real()};
+            if (percentile < 0 || percentile > 100) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, percentiles must be between 0 and 100");
+            }
+            percentiles.push_back(percentile);
+        }
+    }
+    return MempoolFeeHistogramToJSON(EnsureAnyMemPool(request.context), percentiles);
+},
+    };
+}
+
+std::optional<UniValue> MempoolEventsToJSON(const CTxMemPool& pool, uint64_t sequence)
+{
+    std::optional<std::vector<MempoolEvent>> events;
+    UniValue ret(UniValue::VOBJ);
+    {
+        LOCK(pool.cs);
+        events = pool.GetEventsSince(sequence);
+        if (!events) return std::nullopt;
+        ret.pushKV("mempool_sequence", pool.GetSequence());
+    }
+
+    UniValue events_json(UniValue::VARR);
+    for (const MempoolEvent& event : *events) {
+        UniValue e(UniValue::VOBJ);
+        e.pushKV("sequence", event.sequence);
+        e.pushKV("type", event.removal_reason ? "removed" : "added");
+        e.pushKV("txid", event.txid.GetHex());
+        e.pushKV("wtxid", event.wtxid.GetHex());
+        if (event.removal_reason) {
+            e.pushKV("reason", RemovalReasonToString(*event.removal_reason));
+        }
+        events_json.push_back(std::move(e));
+    }
+    ret.pushKV("events", std::move(events_json));
+    return ret;
+}
+
+static RPCHelpMan getmempoolevents()
+{
+    return RPCHelpMan{"getmempoolevents",
+        "Returns the transactions added to and removed from the mempool since the given mempool sequence number, in order.\n"
+        "Together with getrawmempool with mempool_sequence=true, this allows clients to keep a copy of the mempool up to date without a full resync after missing notifications.\n"
+        "Only the most recent events are kept (see -mempooleventlog). If events since the given sequence are no longer available, the client has to resync with getrawmempool.\n",
+        {
+            {"sequence", RPCArg::Type::NUM, RPCArg::Optional::NO, "The first mempool sequence number to return events for, i.e. the mempool_sequence returned by the previous call or by getrawmempool"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "mempool_sequence", "The mempool sequence value to pass to the next call"},
+                {RPCResult::Type::ARR, "events", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "sequence", "The mempool sequence value of this event"},
+                        {RPCResult::Type::STR, "type", "\"added\" or \"removed\""},
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                        {RPCResult::Type::STR_HEX, "wtxid", "The transaction witness id"},
+                        {RPCResult::Type::STR, "reason", /*optional=*/true, "Why the transaction was removed (expiry, sizelimit, reorg, block, conflict or replaced)"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getmempoolevents", "1000")
+            + HelpExampleRpc("getmempoolevents", "1000")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int64_t sequence{request.params[0].getInt<int64_t>()};
+    if (sequence < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, sequence must be non-negative");
+    }
+    auto ret{MempoolEventsToJSON(EnsureAnyMemPool(request.context), sequence)};
+    if (!ret) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Mempool events since sequence %d are not available, resync with getrawmempool", sequence));
+    }
+    return std::move(*ret);
+},
+    };
+}
+
 static RPCHelpMan importmempool()
 {
     return RPCHelpMan{
@@ -1022,8 +1229,10 @@ void RegisterMempoolRPCCommands(CRPCTable& t)
         {"blockchain", &getmempoolancestors},
         {"blockchain", &getmempooldescendants},
         {"blockchain", &getmempoolentry},
+        {"blockchain", &getmempoolevents},
         {"blockchain", &gettxspendingprevout},
         {"blockchain", &getmempoolinfo},
+        {"blockchain", &getmempoolfeehistogram},
         {"blockchain", &getrawmempool},
         {"blockchain", &importmempool},
         {"blockchain", &savemempool},
@@ -5,12 +5,25 @@
 #ifndef BITCOIN_RPC_MEMPOOL_H
 #define BITCOIN_RPC_MEMPOOL_H
 
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 class CTxMemPool;
 class UniValue;
 
+/** Percentiles reported by the mempool feerate histogram when none are requested */
+static const std::vector<double> DEFAULT_FEE_HISTOGRAM_PERCENTILES{5, 10, 25, 50, 75, 90, 95};
+
 /** Mempool information to JSON */
 UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 
+/** Mempool feerate histogram and percentiles to JSON */
+UniValue MempoolFeeHistogramToJSON(const CTxMemPool& pool, const std::vector<double>& percentiles = DEFAULT_FEE_HISTOGRAM_PERCENTILES);
+
+/** Mempool events since the given sequence number to JSON, or nullopt if they are not available */
+std::optional<UniValue> MempoolEventsToJSON(const CTxMemPool& pool, uint64_t sequence);
+
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
@@ -428,6 +428,91 @@ static RPCHelpMan getrawtransaction()
     };
 }
 
+static RPCHelpMan getrawtransactions()
+{
+    return RPCHelpMan{
+        "getrawtransactions",
+        "Return many transactions from the mempool or, if -txindex is enabled, from any block.\n"
+        "This is faster than calling getrawtransaction for each transaction, as the transactions\n"
+        "are read from disk in the order they are stored in.\n",
+        {
+            {"txids", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction ids",
+                {
+                    {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "A transaction id"},
+                },
+            },
+            {"verbose", RPCArg::Type::BOOL, RPCArg::Default{false}, "If false, return hex-encoded data, otherwise a JSON object for each transaction"},
+        },
+        {
+            RPCResult{"if verbose is not set or set to false",
+                RPCResult::Type::ARR, "", "One entry per txid, in the same order",
+                {
+                    {RPCResult::Type::STR_HEX, "data", "The serialized, hex-encoded transaction, or null if it is not found", {}, /*skip_type_check=*/true},
+                },
+            },
+            RPCResult{"if verbose is set to true",
+                RPCResult::Type::ARR, "", "One entry per txid, in the same order",
+                {
+                    {RPCResult::Type::OBJ, "", "The transaction, or null if it is not found",
+                    {
+                        {RPCResult::Type::ELISION, "", "Same output as getrawtransaction with verbosity = 1"},
+                    }, /*skip_type_check=*/true},
+                },
+            },
+        },
+        RPCExamples{
+            HelpExampleCli("getrawtransactions", "\"[\\\"mytxid\\\",\\\"mytxid2\\\"]\"")
+            + HelpExampleCli("getrawtransactions", "\"[\\\"mytxid\\\",\\\"mytxid2\\\"]\" true")
+            + HelpExampleRpc("getrawtransactions", "[\"mytxid\",\"mytxid2\"], true")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+
+    const UniValue& txids{request.params[0].get_array()};
+    const bool verbose{request.params[1].isNull() ? false : request.params[1].get_bool()};
+
+    std::vector<std::pair<uint256, CTransactionRef>> txs(txids.size());
+    std::vector<uint256> to_find;
+    std::vector<size_t> to_find_index;
+    for (size_t i = 0; i < txids.size(); ++i) {
+        const uint256 hash{ParseHashV(txids[i], "txid")};
+        if (node.mempool) {
+            if (CTransactionRef tx{node.mempool->get(hash)}) {
+                txs[i].second = std::move(tx);
+                continue;
+            }
+        }
+        to_find.push_back(hash);
+        to_find_index.push_back(i);
+    }
+
+    if (!to_find.empty() && g_txindex && g_txindex->BlockUntilSyncedToCurrentChain()) {
+        std::vector<std::pair<uint256, CTransactionRef>> found;
+        g_txindex->FindTxs(to_find, found);
+        for (size_t j = 0; j < found.size(); ++j) {
+            if (found[j].second) txs[to_find_index[j]] = std::move(found[j]);
+        }
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const auto& [hash_block, tx] : txs) {
+        if (!tx) {
+            result.push_back(UniValue{});
+        } else if (!verbose) {
+            result.push_back(EncodeHexTx(*tx));
+        } else {
+            UniValue entry(UniValue::VOBJ);
+            TxToJSON(*tx, hash_block, entry, chainman.ActiveChainstate());
+            result.push_back(std::move(entry));
+        }
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan createrawtransaction()
 {
     return RPCHelpMan{"createrawtransaction",
@@ -2016,6 +2101,7 @@ void RegisterRawTransactionRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"rawtransactions", &getrawtransaction},
+        {"rawtransactions", &getrawtransactions},
         {"rawtransactions", &createrawtransaction},
         {"rawtransactions", &decoderawtransaction},
         {"rawtransactions", &decodescript},
@@ -11,9 +11,11 @@
 #include <interfaces/chain.h>
 #include <node/miner.h>
 #include <pow.h>
+#include <streams.h>
 #include <test/util/blockfilter.h>
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
+#include <util/strencodings.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -270,6 +272,78 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_sync, BuildChainTestingSetup)
+{
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    BOOST_REQUIRE(filter_index.Init());
+
+    // Read and compute filters on several threads, they are still appended in order.
+    BOOST_REQUIRE(filter_index.StartBackgroundSync(/*workers=*/4));
+    IndexWaitSynced(filter_index, *Assert(m_node.shutdown));
+
+    {
+        LOCK(cs_main);
+        uint256 last_header;
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+        }
+    }
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_encoded_range, BuildChainTestingSetup)
+{
+    // Without a cache every lookup reads from disk, with one repeated lookups are served from it.
+    for (const size_t cache_size : {size_t{0}, size_t{1} << 20}) {
+        BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, cache_size, true, true);
+        BOOST_REQUIRE(filter_index.Init());
+        BOOST_REQUIRE(filter_index.StartBackgroundSync());
+        IndexWaitSynced(filter_index, *Assert(m_node.shutdown));
+
+        const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        for (int i = 0; i < 2; ++i) {
+            std::vector<EncodedBlockFilter> encoded_filters;
+            std::vector<BlockFilter> filters;
+            BOOST_REQUIRE(filter_index.LookupEncodedFilterRange(0, tip, encoded_filters));
+            BOOST_REQUIRE(filter_index.LookupFilterRange(0, tip, filters));
+            BOOST_REQUIRE_EQUAL(encoded_filters.size(), tip->nHeight + 1U);
+            BOOST_REQUIRE_EQUAL(filters.size(), encoded_filters.size());
+
+            for (const CBlockIndex* block_index = tip; block_index; block_index = block_index->pprev) {
+                const size_t height{static_cast<size_t>(block_index->nHeight)};
+                BlockFilter expected_filter;
+                BOOST_REQUIRE(ComputeFilter(BlockFilterType::BASIC, *block_index, expected_filter, m_node.chainman->m_blockman));
+                BOOST_CHECK(encoded_filters[height].filter_type == BlockFilterType::BASIC);
+                BOOST_CHECK_EQUAL(encoded_filters[height].block_hash, block_index->GetBlockHash());
+                BOOST_CHECK(*encoded_filters[height].encoded_filter == expected_filter.GetEncodedFilter());
+                BOOST_CHECK(filters[height].GetEncodedFilter() == expected_filter.GetEncodedFilter());
+
+                // The encoded filter serializes like the decoded one.
+                DataStream encoded_ser, filter_ser;
+                encoded_ser << encoded_filters[height];
+                filter_ser << expected_filter;
+                BOOST_CHECK_EQUAL(HexStr(encoded_ser), HexStr(filter_ser));
+            }
+
+            // Sub-ranges return the same filters.
+            const CBlockIndex* stop_index{tip->GetAncestor(50)};
+            std::vector<EncodedBlockFilter> sub_range;
+            BOOST_REQUIRE(filter_index.LookupEncodedFilterRange(25, stop_index, sub_range));
+            BOOST_REQUIRE_EQUAL(sub_range.size(), 26U);
+            for (size_t j = 0; j < sub_range.size(); ++j) {
+                BOOST_CHECK(*sub_range[j].encoded_filter == *encoded_filters[25 + j].encoded_filter);
+            }
+        }
+
+        filter_index.Interrupt();
+        filter_index.Stop();
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
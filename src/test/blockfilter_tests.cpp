@@ -12,6 +12,7 @@
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -41,6 +42,54 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_encoder_decoder)
+{
+    FastRandomContext rng;
+    for (const uint8_t P : {0, 1, 7, 19, 40, 63}) {
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 500; ++i) {
+            // Mostly small quotients, with a few of more than 64 bits of unary code.
+            const uint64_t q{i % 100 == 0 ? 100 + rng.randrange(100U) : rng.randrange(8U)};
+            values.push_back((q << P) + (P ? rng.randbits(P) : 0));
+        }
+
+        // Same encoding as the bit by bit encoder.
+        std::vector<unsigned char> encoded, expected;
+        {
+            VectorWriter stream{expected, 0};
+            BitStreamWriter bitwriter{stream};
+            GolombRiceEncoder encoder{encoded};
+            for (const uint64_t x : values) {
+                GolombRiceEncode(bitwriter, P, x);
+                encoder.Encode(P, x);
+            }
+            encoder.Flush();
+        }
+        BOOST_CHECK_EQUAL(HexStr(encoded), HexStr(expected));
+
+        // Same values as the bit by bit decoder.
+        GolombRiceDecoder decoder{encoded};
+        SpanReader stream{encoded};
+        BitStreamReader bitreader{stream};
+        for (const uint64_t x : values) {
+            BOOST_CHECK_EQUAL(GolombRiceDecode(bitreader, P), x);
+            BOOST_CHECK_EQUAL(decoder.Decode(P), x);
+        }
+        BOOST_CHECK(decoder.Exhausted());
+        BOOST_CHECK(stream.empty());
+
+        // Decoding past the end fails.
+        GolombRiceDecoder truncated{Span{encoded}.first(encoded.size() - 1)};
+        BOOST_CHECK_THROW(for (size_t i = 0; i < values.size(); ++i) truncated.Decode(P), std::ios_base::failure);
+
+        // Excess data is detected.
+        encoded.push_back(0);
+        GolombRiceDecoder excess{encoded};
+        for (size_t i = 0; i < values.size(); ++i) excess.Decode(P);
+        BOOST_CHECK(!excess.Exhausted());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
 {
     GCSFilter filter;
@@ -14,7 +14,9 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <initializer_list>
 #include <map>
+#include <optional>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -1100,6 +1102,49 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_get_coins)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {.read_threads = 2}};
+    std::vector<COutPoint> outpoints;
+    for (int i = 0; i < 300; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), m_rng.randrange(4));
+    }
+    CCoinsViewCache flushed{&base};
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        if (i % 3 == 0) continue;
+        flushed.AddCoin(outpoints[i], Coin{CTxOut{int64_t(i), CScript{} << OP_TRUE}, int(i), false}, /*possible_overwrite=*/false);
+    }
+    flushed.SetBestBlock(m_rng.rand256());
+    BOOST_CHECK(flushed.Flush());
+
+    // Spend some of the coins and add others in a cache that is not flushed.
+    CCoinsViewCache cache{&base};
+    for (size_t i = 0; i < outpoints.size(); i += 5) {
+        if (i % 3 != 0) BOOST_CHECK(cache.SpendCoin(outpoints[i]));
+    }
+    cache.AddCoin(outpoints[0], Coin{CTxOut{1, CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/false);
+    // Outpoints may be given more than once.
+    outpoints.push_back(outpoints[1]);
+    outpoints.push_back(outpoints[3]);
+
+    // Coins fetched at once are those fetched one at a time, through any view.
+    for (CCoinsView* view : std::initializer_list<CCoinsView*>{&base, &cache}) {
+        CCoinsViewCache child{view};
+        std::vector<std::optional<Coin>> coins;
+        child.GetCoins(outpoints, coins);
+        BOOST_REQUIRE_EQUAL(coins.size(), outpoints.size());
+        for (size_t i = 0; i < outpoints.size(); ++i) {
+            Coin coin;
+            const bool found{view->GetCoin(outpoints[i], coin)};
+            BOOST_CHECK_EQUAL(coins[i].has_value(), found);
+            if (found) BOOST_CHECK(*coins[i] == coin);
+            BOOST_CHECK_EQUAL(child.HaveCoinInCache(outpoints[i]), found);
+        }
+    }
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoints[3]));
+    BOOST_CHECK(cache.HaveCoinInCache(outpoints[1]));
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
@@ -13,6 +13,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <stdexcept>
+
 BOOST_AUTO_TEST_SUITE(coinstatsindex_tests)
 
 BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
@@ -118,4 +120,42 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(compute_utxo_stats_threads, TestChain100Setup)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    WITH_LOCK(::cs_main, chainstate.ForceFlushStateToDisk());
+    CCoinsViewDB& coins_db{WITH_LOCK(::cs_main, return chainstate.CoinsDB())};
+
+    for (const auto hash_type : {kernel::CoinStatsHashType::HASH_SERIALIZED, kernel::CoinStatsHashType::MUHASH, kernel::CoinStatsHashType::NONE}) {
+        const auto expected{kernel::ComputeUTXOStats(hash_type, &coins_db, m_node.chainman->m_blockman)};
+        BOOST_REQUIRE(expected);
+        BOOST_CHECK_EQUAL(expected->coins_count, 100U);
+        for (const int threads : {2, 7}) {
+            double last_progress{0};
+            const kernel::UTXOStatsOptions options{
+                .threads = threads,
+                .progress = [&](double progress) {
+                    BOOST_CHECK(progress >= last_progress && progress <= 1);
+                    last_progress = progress;
+                },
+            };
+            const auto stats{kernel::ComputeUTXOStats(hash_type, &coins_db, m_node.chainman->m_blockman, {}, options)};
+            BOOST_REQUIRE(stats);
+            BOOST_CHECK_EQUAL(stats->hashSerialized, expected->hashSerialized);
+            BOOST_CHECK_EQUAL(stats->hashBlock, expected->hashBlock);
+            BOOST_CHECK_EQUAL(stats->coins_count, expected->coins_count);
+            BOOST_CHECK_EQUAL(stats->nTransactions, expected->nTransactions);
+            BOOST_CHECK_EQUAL(stats->nTransactionOutputs, expected->nTransactionOutputs);
+            BOOST_CHECK_EQUAL(stats->nBogoSize, expected->nBogoSize);
+            BOOST_CHECK(stats->total_amount == expected->total_amount);
+        }
+    }
+
+    // An exception thrown by the interruption point on any thread is passed on.
+    const kernel::UTXOStatsOptions options{.threads = 4};
+    BOOST_CHECK_THROW(kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, &coins_db, m_node.chainman->m_blockman,
+                                               [] { throw std::runtime_error{"interrupted"}; }, options),
+                      std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,7 +8,9 @@
 #include <uint256.h>
 #include <util/string.h>
 
+#include <map>
 #include <memory>
+#include <optional>
 
 #include <boost/test/unit_test.hpp>
 
@@ -125,6 +127,113 @@ BOOST_AUTO_TEST_CASE(dbwrapper_basic_data)
    }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_tuning)
+{
+    const fs::path ph = m_args.GetDataDirBase() / "dbwrapper_tuning";
+    const std::vector<DBTuning> tunings{
+        DB_TUNING_RANDOM_ACCESS,
+        DB_TUNING_APPEND_MOSTLY,
+        DBTuning{.compression = true, .bloom_bits_per_key = 0, .max_file_size = 1 << 16},
+    };
+    std::vector<std::pair<uint32_t, uint256>> entries;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        entries.emplace_back(i, m_rng.rand256());
+    }
+
+    // Data written with any tuning can be read with any other one.
+    for (size_t i = 0; i < tunings.size(); ++i) {
+        {
+            CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .wipe_data = true, .tuning = tunings[i]});
+            CDBBatch batch(dbw);
+            for (const auto& [key, value] : entries) batch.Write(key, value);
+            BOOST_CHECK(dbw.WriteBatch(batch));
+        }
+        // Write the entries to table files with the same tuning.
+        CDBWrapper({.path = ph, .cache_bytes = 1 << 20, .options = {.force_compact = true}, .tuning = tunings[i]});
+        CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .tuning = tunings[(i + 1) % tunings.size()]});
+        for (const auto& [key, value] : entries) {
+            uint256 res;
+            BOOST_CHECK(dbw.Read(key, res));
+            BOOST_CHECK_EQUAL(res, value);
+        }
+        BOOST_CHECK(!dbw.Exists(uint32_t{1000}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_compaction)
+{
+    const fs::path ph = m_args.GetDataDirBase() / "dbwrapper_compaction";
+    // Rate limit compactions, well above what slows down the test.
+    CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .wipe_data = true, .options = {.max_compaction_rate = 1 << 30}});
+    std::vector<std::pair<uint256, uint256>> entries;
+    for (int i = 0; i < 20'000; ++i) {
+        entries.emplace_back(m_rng.rand256(), m_rng.rand256());
+    }
+    for (size_t i = 0; i < entries.size(); i += 1'000) {
+        CDBBatch batch(dbw);
+        for (size_t j = i; j < i + 1'000; ++j) batch.Write(entries[j].first, entries[j].second);
+        BOOST_CHECK(dbw.WriteBatch(batch));
+    }
+
+    // Compact the whole database in small steps.
+    int steps{1};
+    while (!dbw.CompactStep(/*max_bytes=*/64 << 10)) ++steps;
+    BOOST_CHECK_GT(steps, 1);
+
+    const DBCompactionStats stats{dbw.GetCompactionStats()};
+    BOOST_REQUIRE(!stats.levels.empty());
+    BOOST_CHECK_EQUAL(stats.levels[0].files, 0);
+    int files{0};
+    uint64_t bytes{0};
+    for (const auto& level : stats.levels) {
+        files += level.files;
+        bytes += level.bytes;
+    }
+    BOOST_CHECK_GT(files, 0);
+    BOOST_CHECK_GT(bytes, entries.size() * 64);
+    BOOST_CHECK_EQUAL(stats.pending_bytes, 0U);
+
+    for (const auto& [key, value] : entries) {
+        uint256 res;
+        BOOST_CHECK(dbw.Read(key, res));
+        BOOST_CHECK_EQUAL(res, value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_read_many)
+{
+    for (const int read_threads : {0, 3}) {
+        const fs::path ph = m_args.GetDataDirBase() / "dbwrapper_read_many";
+        CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .wipe_data = true, .obfuscate = true, .read_threads = read_threads});
+        std::map<uint32_t, uint256> entries;
+        CDBBatch batch(dbw);
+        for (uint32_t i = 0; i < 1000; i += 2) {
+            entries[i] = m_rng.rand256();
+            batch.Write(i, entries[i]);
+        }
+        // A value that does not deserialize as a uint256.
+        batch.Write(uint32_t{1001}, uint8_t{0});
+        BOOST_CHECK(dbw.WriteBatch(batch));
+
+        // Keys in random order, some of them missing or given twice.
+        std::vector<uint32_t> keys;
+        for (uint32_t i = 0; i < 1002; ++i) keys.push_back(m_rng.randrange(1002));
+        std::vector<std::optional<uint256>> values;
+        dbw.ReadMany(keys, values);
+        BOOST_REQUIRE_EQUAL(values.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (entries.count(keys[i])) {
+                BOOST_CHECK(values[i] == entries[keys[i]]);
+            } else {
+                BOOST_CHECK(!values[i]);
+            }
+        }
+
+        dbw.ReadMany(std::vector<uint32_t>{}, values);
+        BOOST_CHECK(values.empty());
+    }
+}
+
 // Test batch operations
 BOOST_AUTO_TEST_CASE(dbwrapper_batch)
 {
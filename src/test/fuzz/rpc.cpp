@@ -128,6 +128,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getchaintips",
     "getchainstates",
     "getchaintxstats",
+    "getcompactionstats",
     "getconnectioncount",
     "getdeploymentinfo",
     "getdescriptorinfo",
@@ -137,6 +138,8 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getmempoolancestors",
     "getmempooldescendants",
     "getmempoolentry",
+    "getmempoolevents",
+    "getmempoolfeehistogram",
     "getmempoolinfo",
     "getmininginfo",
     "getnettotals",
@@ -148,7 +151,9 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawaddrman",
     "getrawmempool",
     "getrawtransaction",
+    "getrawtransactions",
     "getrpcinfo",
+    "getscripthistory",
     "gettxout",
     "gettxoutsetinfo",
     "gettxspendingprevout",
@@ -148,4 +148,34 @@ BOOST_AUTO_TEST_CASE(siphash)
     }
 }
 
+BOOST_AUTO_TEST_CASE(siphash_batch)
+{
+    // Check consistency between CSipHasher and SipHashBatch, for any number of messages of any size.
+    FastRandomContext ctx;
+    for (size_t count = 0; count < 12; ++count) {
+        const uint64_t k0{ctx.rand64()};
+        const uint64_t k1{ctx.rand64()};
+        std::vector<std::vector<unsigned char>> messages;
+        for (size_t i = 0; i < count; ++i) {
+            messages.push_back(ctx.randbytes(ctx.randrange(80)));
+        }
+        std::vector<Span<const unsigned char>> spans(messages.begin(), messages.end());
+        std::vector<uint64_t> hashes(count);
+        SipHashBatch(k0, k1, spans, hashes);
+        for (size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(hashes[i], CSipHasher(k0, k1).Write(messages[i]).Finalize());
+        }
+    }
+
+    // Test vectors from spec.
+    std::vector<unsigned char> message;
+    for (uint8_t x = 0; x < std::size(siphash_4_2_testvec); ++x) {
+        uint64_t hash;
+        const Span<const unsigned char> span{message};
+        SipHashBatch(0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL, {&span, 1}, {&hash, 1});
+        BOOST_CHECK_EQUAL(hash, siphash_4_2_testvec[x]);
+        message.push_back(x);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,10 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <common/system.h>
+#include <policy/feerate_histogram.h>
 #include <policy/policy.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
 #include <util/time.h>
+#include <util/translation.h>
 
 #include <test/util/setup_common.h>
 
@@ -804,4 +806,210 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTestsDiamond)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolFeerateHistogramTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    const auto bucket_of = [](CAmount feerate) {
+        return FeerateHistogram::BucketIndex(feerate, 1);
+    };
+
+    CMutableTransaction parent;
+    parent.vin.resize(1);
+    parent.vin[0].scriptSig = CScript() << OP_1;
+    parent.vout.resize(1);
+    parent.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    parent.vout[0].nValue = 10 * COIN;
+    const int64_t parent_size{GetVirtualTransactionSize(CTransaction(parent))};
+    pool.addUnchecked(entry.Fee(2 * parent_size).FromTx(parent));
+
+    CMutableTransaction child;
+    child.vin.resize(1);
+    child.vin[0].prevout = COutPoint(parent.GetHash(), 0);
+    child.vin[0].scriptSig = CScript() << OP_11;
+    child.vout.resize(1);
+    child.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    child.vout[0].nValue = 10 * COIN;
+    const int64_t child_size{GetVirtualTransactionSize(CTransaction(child))};
+    pool.addUnchecked(entry.Fee(50 * child_size).FromTx(child));
+
+    // The child is counted at its ancestor package feerate, which is lower than its own
+    const CAmount package_feerate{(2 * parent_size + 50 * child_size) / (parent_size + child_size)};
+    {
+        const auto& histogram{pool.GetFeerateHistogram()};
+        BOOST_CHECK_EQUAL(histogram.GetTotalCount(), 2U);
+        BOOST_CHECK_EQUAL(histogram.GetTotalVsize(), pool.GetTotalTxSize());
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(2)].vsize, parent_size);
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(package_feerate)].vsize, child_size);
+        BOOST_CHECK_EQUAL(histogram.GetPercentile(0).GetFeePerK(), 2000);
+        BOOST_CHECK_EQUAL(histogram.GetPercentile(100).GetFeePerK(), FeerateHistogram::BUCKET_BOUNDARIES[bucket_of(package_feerate)] * 1000);
+    }
+
+    // Prioritising the parent moves both transactions
+    pool.PrioritiseTransaction(parent.GetHash(), 98 * parent_size);
+    {
+        const auto& histogram{pool.GetFeerateHistogram()};
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(100)].vsize, parent_size);
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(50)].vsize, child_size);
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(100)].fees, 2 * parent_size);
+    }
+    pool.PrioritiseTransaction(parent.GetHash(), -98 * parent_size);
+
+    // Confirming the parent leaves the child at its own feerate
+    pool.removeForBlock({MakeTransactionRef(parent)}, 1);
+    {
+        const auto& histogram{pool.GetFeerateHistogram()};
+        BOOST_CHECK_EQUAL(histogram.GetTotalCount(), 1U);
+        BOOST_CHECK_EQUAL(histogram.GetTotalVsize(), child_size);
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(50)].vsize, child_size);
+        BOOST_CHECK_EQUAL(histogram.GetBuckets()[bucket_of(50)].fees, 50 * child_size);
+    }
+
+    pool.removeRecursive(CTransaction(child), REMOVAL_REASON_DUMMY);
+    BOOST_CHECK(pool.GetFeerateHistogram() == FeerateHistogram{});
+}
+
+BOOST_AUTO_TEST_CASE(MempoolSnapshotTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // parent signals BIP125 replaceability, child inherits it, unrelated does not
+    CMutableTransaction parent;
+    parent.vin.resize(1);
+    parent.vin[0].scriptSig = CScript() << OP_1;
+    parent.vin[0].nSequence = 0;
+    parent.vout.resize(2);
+    for (auto& out : parent.vout) {
+        out.scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        out.nValue = 10 * COIN;
+    }
+    pool.addUnchecked(entry.Fee(1000).FromTx(parent));
+
+    CMutableTransaction child;
+    child.vin.resize(1);
+    child.vin[0].prevout = COutPoint(parent.GetHash(), 0);
+    child.vin[0].scriptSig = CScript() << OP_11;
+    child.vout.resize(1);
+    child.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    child.vout[0].nValue = 10 * COIN;
+    pool.addUnchecked(entry.Fee(2000).FromTx(child));
+
+    CMutableTransaction unrelated;
+    unrelated.vin.resize(1);
+    unrelated.vin[0].scriptSig = CScript() << OP_2;
+    unrelated.vout.resize(1);
+    unrelated.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    unrelated.vout[0].nValue = 10 * COIN;
+    pool.addUnchecked(entry.Fee(3000).FromTx(unrelated));
+
+    BOOST_CHECK(!pool.GetCurrentSnapshot());
+    const auto snapshot{pool.GetSnapshot()};
+    BOOST_CHECK(pool.GetCurrentSnapshot() == snapshot);
+    BOOST_CHECK(pool.GetSnapshot() == snapshot);
+    BOOST_CHECK_EQUAL(snapshot->entries.size(), 3U);
+    BOOST_CHECK_EQUAL(snapshot->sequence, pool.GetSequence());
+    BOOST_CHECK_EQUAL(snapshot->total_tx_size, pool.GetTotalTxSize());
+
+    // Entries are in the same order as entryAll() and derive the same
+    // ancestor-dependent fields as a single entry copied under the lock
+    const auto all{pool.entryAll()};
+    for (size_t i = 0; i < all.size(); ++i) {
+        const MempoolSnapshot::Entry& e{snapshot->entries[i]};
+        const MempoolSnapshot::Entry expected{pool.MakeSnapshotEntry(all[i])};
+        BOOST_CHECK(e.tx == expected.tx);
+        BOOST_CHECK(snapshot->Find(e.tx->GetHash()) == &e);
+        BOOST_CHECK_EQUAL(e.modified_fee, expected.modified_fee);
+        BOOST_CHECK_EQUAL(e.count_with_ancestors, expected.count_with_ancestors);
+        BOOST_CHECK_EQUAL(e.count_with_descendants, expected.count_with_descendants);
+        BOOST_CHECK_EQUAL(e.descendant_maximum, expected.descendant_maximum);
+        BOOST_CHECK_EQUAL(e.bip125_replaceable, expected.bip125_replaceable);
+        BOOST_CHECK(e.parents == expected.parents);
+        BOOST_CHECK(e.children == expected.children);
+    }
+    BOOST_CHECK(snapshot->Find(parent.GetHash())->bip125_replaceable);
+    BOOST_CHECK(snapshot->Find(child.GetHash())->bip125_replaceable);
+    BOOST_CHECK(!snapshot->Find(unrelated.GetHash())->bip125_replaceable);
+    BOOST_CHECK_EQUAL(snapshot->Find(child.GetHash())->descendant_maximum, 2U);
+    BOOST_CHECK(!pool.GetSnapshotEntry(Txid::FromUint256(uint256::ONE)));
+
+    // Any change visible in a snapshot invalidates it, but never modifies it
+    pool.PrioritiseTransaction(unrelated.GetHash(), 500);
+    BOOST_CHECK(!pool.GetCurrentSnapshot());
+    BOOST_CHECK_EQUAL(pool.GetSnapshotEntry(unrelated.GetHash())->modified_fee, 3500);
+    BOOST_CHECK_EQUAL(snapshot->Find(unrelated.GetHash())->modified_fee, 3000);
+    const auto prioritised{pool.GetSnapshot()};
+    BOOST_CHECK(prioritised != snapshot);
+    BOOST_CHECK_EQUAL(prioritised->Find(unrelated.GetHash())->modified_fee, 3500);
+
+    pool.AddUnbroadcastTx(child.GetHash());
+    BOOST_CHECK(!pool.GetCurrentSnapshot());
+    BOOST_CHECK(pool.GetSnapshot()->Find(child.GetHash())->unbroadcast);
+
+    pool.removeRecursive(CTransaction(parent), REMOVAL_REASON_DUMMY);
+    BOOST_CHECK(!pool.GetCurrentSnapshot());
+    BOOST_CHECK_EQUAL(pool.GetSnapshot()->entries.size(), 1U);
+    BOOST_CHECK(!pool.GetSnapshotEntry(child.GetHash()));
+    BOOST_CHECK_EQUAL(prioritised->entries.size(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolEventLogTest)
+{
+    auto opts{MemPoolOptionsForTest(m_node)};
+    opts.event_log_size = 3;
+    bilingual_str error;
+    CTxMemPool pool{opts, error};
+    BOOST_REQUIRE(error.empty());
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < 3; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << i;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+        txs.push_back(MakeTransactionRef(tx));
+    }
+
+    const uint64_t start{pool.GetSequence()};
+    BOOST_CHECK(pool.GetEventsSince(start)->empty());
+    BOOST_CHECK(!pool.GetEventsSince(start + 1));
+
+    pool.addUnchecked(entry.FromTx(txs[0]));
+    BOOST_CHECK_EQUAL(pool.LogTransactionAdded(*txs[0]), start);
+    pool.addUnchecked(entry.FromTx(txs[1]));
+    BOOST_CHECK_EQUAL(pool.LogTransactionAdded(*txs[1]), start + 1);
+    pool.removeRecursive(*txs[0], MemPoolRemovalReason::CONFLICT);
+
+    auto events{pool.GetEventsSince(start)};
+    BOOST_REQUIRE(events);
+    BOOST_REQUIRE_EQUAL(events->size(), 3U);
+    BOOST_CHECK_EQUAL((*events)[0].sequence, start);
+    BOOST_CHECK((*events)[0].txid == txs[0]->GetHash());
+    BOOST_CHECK((*events)[0].wtxid == txs[0]->GetWitnessHash());
+    BOOST_CHECK(!(*events)[0].removal_reason);
+    BOOST_CHECK((*events)[1].txid == txs[1]->GetHash());
+    BOOST_CHECK_EQUAL((*events)[2].sequence, start + 2);
+    BOOST_CHECK((*events)[2].txid == txs[0]->GetHash());
+    BOOST_CHECK((*events)[2].removal_reason == MemPoolRemovalReason::CONFLICT);
+    BOOST_CHECK_EQUAL(pool.GetEventsSince(start + 2)->size(), 1U);
+    BOOST_CHECK(pool.GetEventsSince(start + 3)->empty());
+
+    // The oldest event is dropped once the log is full
+    pool.addUnchecked(entry.FromTx(txs[2]));
+    pool.LogTransactionAdded(*txs[2]);
+    BOOST_CHECK(!pool.GetEventsSince(start));
+    events = pool.GetEventsSince(start + 1);
+    BOOST_REQUIRE(events);
+    BOOST_CHECK_EQUAL(events->size(), 3U);
+    BOOST_CHECK_EQUAL(events->back().sequence, start + 3);
+    BOOST_CHECK_EQUAL(pool.GetSequence(), start + 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -709,4 +709,68 @@ BOOST_FIXTURE_TEST_CASE(manual_ctor, TestChain100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(miniminer_cluster_cache, TestChain100Setup)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // Low-feerate parent tx0 with a child tx1 spending one of its outputs, and an unrelated tx2
+    const auto tx0 = make_tx({COutPoint{m_coinbase_txns[0]->GetHash(), 0}}, /*num_outputs=*/2);
+    pool.addUnchecked(entry.Fee(low_fee).FromTx(tx0));
+    const auto tx1 = make_tx({COutPoint{tx0->GetHash(), 0}}, /*num_outputs=*/1);
+    pool.addUnchecked(entry.Fee(med_fee).FromTx(tx1));
+    const auto tx2 = make_tx({COutPoint{m_coinbase_txns[1]->GetHash(), 0}}, /*num_outputs=*/1);
+    pool.addUnchecked(entry.Fee(low_fee).FromTx(tx2));
+
+    const std::vector<COutPoint> outpoints{
+        COutPoint{tx0->GetHash(), 0},
+        COutPoint{tx0->GetHash(), 1},
+        COutPoint{tx1->GetHash(), 0},
+        COutPoint{tx2->GetHash(), 0},
+        COutPoint{m_coinbase_txns[2]->GetHash(), 0},
+    };
+    const CFeeRate target_feerate{CENT};
+
+    node::MiniMinerClusterCache cache;
+    const auto check_against_uncached = [&] {
+        const auto expected{node::MiniMiner(pool, outpoints).CalculateBumpFees(target_feerate)};
+        BOOST_CHECK_EQUAL(expected.size(), outpoints.size());
+        BOOST_CHECK(node::MiniMiner(pool, outpoints, cache).CalculateBumpFees(target_feerate) == expected);
+        BOOST_CHECK(node::MiniMiner(pool, outpoints, cache).CalculateBumpFees(target_feerate) == expected);
+        BOOST_CHECK(node::MiniMiner(pool, outpoints, cache).CalculateTotalBumpFees(target_feerate) ==
+                    node::MiniMiner(pool, outpoints).CalculateTotalBumpFees(target_feerate));
+        return expected;
+    };
+
+    const auto bump_fees{check_against_uncached()};
+    // tx1 spends one of the outpoints so it is to be replaced, the confirmed outpoint needs no bump
+    BOOST_CHECK_EQUAL(Find(bump_fees, outpoints[0]), Find(bump_fees, outpoints[1]));
+    BOOST_CHECK_EQUAL(Find(bump_fees, outpoints[2]), 0);
+    BOOST_CHECK_EQUAL(Find(bump_fees, outpoints[4]), 0);
+    BOOST_CHECK(Find(bump_fees, outpoints[3]) > 0);
+
+    // Cached clusters are not reused after the mempool changed
+    pool.PrioritiseTransaction(tx2->GetHash(), CENT);
+    const auto prioritised_bump_fees{check_against_uncached()};
+    BOOST_CHECK_EQUAL(Find(prioritised_bump_fees, outpoints[3]), 0);
+    BOOST_CHECK_EQUAL(Find(prioritised_bump_fees, outpoints[1]), Find(bump_fees, outpoints[1]));
+
+    // A subset of the cached outpoints is served from the cache
+    const std::vector<COutPoint> subset{outpoints[1], outpoints[3]};
+    BOOST_CHECK(node::MiniMiner(pool, subset, cache).CalculateTotalBumpFees(target_feerate) ==
+                node::MiniMiner(pool, subset).CalculateTotalBumpFees(target_feerate));
+
+    // Clusters exceeding the DoS limit cannot be calculated, cached or not
+    auto lasttx = tx2;
+    for (auto i{0}; i < 500; ++i) {
+        const auto tx = make_tx({COutPoint{lasttx->GetHash(), 0}}, /*num_outputs=*/1);
+        pool.addUnchecked(entry.Fee(CENT).FromTx(tx));
+        lasttx = tx;
+    }
+    BOOST_CHECK(!node::MiniMiner(pool, outpoints, cache).IsReadyToCalculate());
+    BOOST_CHECK(!node::MiniMiner(pool, outpoints).IsReadyToCalculate());
+    BOOST_CHECK(node::MiniMiner(pool, {outpoints[1]}, cache).IsReadyToCalculate());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
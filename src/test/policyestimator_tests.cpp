@@ -156,6 +156,18 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 
 
+    // Repeated smart fee queries are answered consistently until the stats change
+    FeeCalculation fee_calc;
+    const CFeeRate smart_fee{feeEst.estimateSmartFee(4, &fee_calc, /*conservative=*/false)};
+    BOOST_CHECK(smart_fee != CFeeRate(0));
+    for (int i = 0; i < 3; i++) {
+        FeeCalculation repeat_calc;
+        BOOST_CHECK(feeEst.estimateSmartFee(4, &repeat_calc, /*conservative=*/false) == smart_fee);
+        BOOST_CHECK_EQUAL(repeat_calc.returnedTarget, fee_calc.returnedTarget);
+        BOOST_CHECK(repeat_calc.reason == fee_calc.reason);
+        BOOST_CHECK_EQUAL(repeat_calc.est.pass.totalConfirmed, fee_calc.est.pass.totalConfirmed);
+    }
+
     // Mine 15 more blocks with lots of transactions happening and not getting mined
     // Estimates should go up
     while (blocknum < 265) {
@@ -194,6 +206,8 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     for (int i = 1; i < 10;i++) {
         BOOST_CHECK(feeEst.estimateFee(i) == CFeeRate(0) || feeEst.estimateFee(i).GetFeePerK() > origFeeEst[i-1] - deltaFee);
     }
+    // The unconfirmed transactions must have dropped the cached smart fee estimate
+    BOOST_CHECK(feeEst.estimateSmartFee(4, nullptr, /*conservative=*/false) != smart_fee);
 
     // Mine all those transactions
     // Estimates should still not be below original
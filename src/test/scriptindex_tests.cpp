@@ -0,0 +1,137 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/amount.h>
+#include <index/scriptindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(scriptindex_tests)
+
+BOOST_AUTO_TEST_CASE(scriptindex_position_encoding)
+{
+    // Serialized positions must sort like the positions themselves, since
+    // they are part of the database keys.
+    const std::vector<ScriptHistoryPosition> positions{
+        {0, 0, false, 0},
+        {0, 0, false, 256},
+        {0, 0, true, 0},
+        {0, 1, false, 0},
+        {1, 0, false, 0},
+        {256, 0, false, 0},
+    };
+    std::vector<unsigned char> prev;
+    for (const auto& pos : positions) {
+        DataStream ss;
+        ss << pos;
+        BOOST_CHECK_EQUAL(ss.size(), 13U);
+        const std::vector<unsigned char> ser(UCharCast(ss.data()), UCharCast(ss.data() + ss.size()));
+        BOOST_CHECK(prev < ser);
+        prev = ser;
+
+        ScriptHistoryPosition read;
+        ss >> read;
+        BOOST_CHECK(read == pos);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(scriptindex_history, TestChain100Setup)
+{
+    ScriptIndex script_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(script_index.Init());
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    std::vector<ScriptHistoryEntry> entries;
+
+    // BlockUntilSyncedToCurrentChain should return false before the index is started.
+    BOOST_CHECK(!script_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(script_index.StartBackgroundSync());
+    IndexWaitSynced(script_index, *Assert(m_node.shutdown));
+
+    // Every block but genesis has a coinbase output paying to coinbase_script.
+    BOOST_REQUIRE(script_index.LookupHistory(coinbase_script, std::nullopt, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 100U);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        BOOST_CHECK_EQUAL(entries[i].pos.height, i + 1);
+        BOOST_CHECK_EQUAL(entries[i].pos.tx_pos, 0U);
+        BOOST_CHECK(!entries[i].pos.spending);
+        BOOST_CHECK_EQUAL(entries[i].txid, m_coinbase_txns[i]->GetHash());
+        BOOST_CHECK_EQUAL(entries[i].amount, 50 * COIN);
+    }
+
+    // Paging through the history gives the same entries.
+    std::vector<ScriptHistoryEntry> paged;
+    std::optional<ScriptHistoryPosition> after;
+    std::vector<ScriptHistoryEntry> page;
+    do {
+        BOOST_REQUIRE(script_index.LookupHistory(coinbase_script, after, 7, page));
+        BOOST_CHECK_LE(page.size(), 7U);
+        paged.insert(paged.end(), page.begin(), page.end());
+        if (!page.empty()) after = page.back().pos;
+    } while (!page.empty());
+    BOOST_REQUIRE_EQUAL(paged.size(), entries.size());
+    for (size_t i = 0; i < paged.size(); ++i) {
+        BOOST_CHECK(paged[i].pos == entries[i].pos);
+    }
+
+    // Unknown scripts have no history.
+    BOOST_REQUIRE(script_index.LookupHistory(CScript() << OP_TRUE, std::nullopt, 1000, entries));
+    BOOST_CHECK(entries.empty());
+
+    // Spend the first coinbase output to a new script.
+    const CScript dest_script{CScript() << OP_TRUE};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, dest_script, 10 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_CHECK(script_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(script_index.LookupHistory(coinbase_script, ScriptHistoryPosition{100, 0, false, 0}, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK(entries[0].pos == (ScriptHistoryPosition{101, 0, false, 0}));
+    BOOST_CHECK(entries[1].pos == (ScriptHistoryPosition{101, 1, true, 0}));
+    BOOST_CHECK_EQUAL(entries[1].txid, spend.GetHash());
+    BOOST_CHECK(entries[1].prevout == COutPoint(m_coinbase_txns[0]->GetHash(), 0));
+    BOOST_CHECK_EQUAL(entries[1].amount, 50 * COIN);
+
+    BOOST_REQUIRE(script_index.LookupHistory(dest_script, std::nullopt, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_CHECK(entries[0].pos == (ScriptHistoryPosition{101, 1, false, 0}));
+    BOOST_CHECK_EQUAL(entries[0].txid, spend.GetHash());
+    BOOST_CHECK_EQUAL(entries[0].amount, 10 * COIN);
+
+    // Replace the tip with an empty block. The entries of the disconnected
+    // block must be removed.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, CScript() << OP_2);
+    BOOST_CHECK(script_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(script_index.LookupHistory(dest_script, std::nullopt, 1000, entries));
+    BOOST_CHECK(entries.empty());
+    BOOST_REQUIRE(script_index.LookupHistory(coinbase_script, std::nullopt, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 100U);
+    BOOST_CHECK_EQUAL(entries.back().pos.height, 100U);
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification. The BlockUntilSyncedToCurrentChain()
+    // call above is sufficient to ensure this, but the
+    // SyncWithValidationInterfaceQueue() call below is also needed to ensure
+    // TSAN always sees the test thread waiting for the notification thread, and
+    // avoid potential false positive reports.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // Shutdown sequence (c.f. Shutdown() in init.cpp)
+    script_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
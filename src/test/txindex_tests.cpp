@@ -4,6 +4,7 @@
 
 #include <addresstype.h>
 #include <chainparams.h>
+#include <consensus/validation.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <test/util/index.h>
@@ -77,4 +78,84 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_parallel_sync, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txindex.Init());
+    BOOST_REQUIRE(txindex.StartBackgroundSync(/*workers=*/4));
+    IndexWaitSynced(txindex, *Assert(m_node.shutdown));
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const auto& txn : m_coinbase_txns) {
+        BOOST_REQUIRE(txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK_EQUAL(tx_disk->GetHash(), txn->GetHash());
+    }
+
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_find_txs, TestChain100Setup)
+{
+    // Without a transaction cache every lookup reads from disk.
+    for (const size_t cache_size : {size_t{0}, size_t{1} << 20}) {
+        TxIndex txindex(interfaces::MakeChain(m_node), cache_size, true, true);
+        BOOST_REQUIRE(txindex.Init());
+        BOOST_REQUIRE(txindex.StartBackgroundSync());
+        IndexWaitSynced(txindex, *Assert(m_node.shutdown));
+
+        // Look up transactions in reverse order, along with an unknown one.
+        std::vector<uint256> tx_hashes{uint256::ONE};
+        for (auto it = m_coinbase_txns.rbegin(); it != m_coinbase_txns.rend(); ++it) {
+            tx_hashes.push_back((*it)->GetHash());
+        }
+        for (int i = 0; i < 2; ++i) {
+            std::vector<std::pair<uint256, CTransactionRef>> txs;
+            txindex.FindTxs(tx_hashes, txs);
+            BOOST_REQUIRE_EQUAL(txs.size(), tx_hashes.size());
+            BOOST_CHECK(!txs[0].second);
+            LOCK(cs_main);
+            for (size_t j = 1; j < txs.size(); ++j) {
+                BOOST_REQUIRE(txs[j].second);
+                BOOST_CHECK_EQUAL(txs[j].second->GetHash(), tx_hashes[j]);
+                const int height{static_cast<int>(m_coinbase_txns.size() - j + 1)};
+                BOOST_CHECK_EQUAL(txs[j].first, m_node.chainman->ActiveChain()[height]->GetBlockHash());
+            }
+        }
+
+        txindex.Stop();
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_cache_reorg, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txindex.Init());
+    BOOST_REQUIRE(txindex.StartBackgroundSync());
+    IndexWaitSynced(txindex, *Assert(m_node.shutdown));
+
+    CMutableTransaction mtx{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                          coinbaseKey, GetScriptForRawPubKey(coinbaseKey.GetPubKey()),
+                                                          /*output_amount=*/CAmount(49 * COIN), /*submit=*/false)};
+    const uint256 first_block{CreateAndProcessBlock({mtx}, CScript() << OP_TRUE).GetHash()};
+    BOOST_REQUIRE(txindex.BlockUntilSyncedToCurrentChain());
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    BOOST_REQUIRE(txindex.FindTx(mtx.GetHash(), block_hash, tx_disk));
+    BOOST_CHECK_EQUAL(block_hash, first_block);
+
+    // The transaction is looked up again once it is in another block.
+    BlockValidationState state;
+    CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    const uint256 second_block{CreateAndProcessBlock({mtx}, CScript() << OP_2).GetHash()};
+    BOOST_REQUIRE(txindex.BlockUntilSyncedToCurrentChain());
+    BOOST_REQUIRE(txindex.FindTx(mtx.GetHash(), block_hash, tx_disk));
+    BOOST_CHECK_EQUAL(block_hash, second_block);
+    BOOST_CHECK_EQUAL(tx_disk->GetHash(), mtx.GetHash());
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
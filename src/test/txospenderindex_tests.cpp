@@ -0,0 +1,85 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/amount.h>
+#include <index/txospenderindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(txospenderindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(txospenderindex_spenders, TestChain100Setup)
+{
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Spend an output before the index is started, so that it is indexed by
+    // the initial sync.
+    const CMutableTransaction synced_spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, coinbase_script, 10 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({synced_spend}, coinbase_script);
+
+    TxoSpenderIndex txospender_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txospender_index.Init());
+
+    // BlockUntilSyncedToCurrentChain should return false before the index is started.
+    BOOST_CHECK(!txospender_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(txospender_index.StartBackgroundSync());
+    IndexWaitSynced(txospender_index, *Assert(m_node.shutdown));
+
+    const COutPoint synced_prevout{m_coinbase_txns[0]->GetHash(), 0};
+    auto spender{txospender_index.FindSpender(synced_prevout)};
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, synced_spend.GetHash());
+    BOOST_CHECK_EQUAL(spender->height, 101U);
+
+    // Unspent outputs are not found
+    BOOST_CHECK(!txospender_index.FindSpender({m_coinbase_txns[1]->GetHash(), 0}));
+    BOOST_CHECK(!txospender_index.FindSpender({synced_spend.GetHash(), 0}));
+
+    // Check that blocks connected after the index is in sync are indexed.
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/2, coinbaseKey, coinbase_script, 10 * COIN, /*submit=*/false)};
+    const CMutableTransaction child_spend{CreateValidMempoolTransaction(MakeTransactionRef(spend), /*input_vout=*/0, /*input_height=*/102, coinbaseKey, coinbase_script, 5 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend, child_spend}, coinbase_script);
+    BOOST_CHECK(txospender_index.BlockUntilSyncedToCurrentChain());
+
+    spender = txospender_index.FindSpender({m_coinbase_txns[1]->GetHash(), 0});
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, spend.GetHash());
+    BOOST_CHECK_EQUAL(spender->height, 102U);
+    spender = txospender_index.FindSpender({spend.GetHash(), 0});
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, child_spend.GetHash());
+
+    // Replace the tip with an empty block. The spends of the disconnected
+    // block must be removed.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, CScript() << OP_2);
+    BOOST_CHECK(txospender_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_CHECK(!txospender_index.FindSpender({m_coinbase_txns[1]->GetHash(), 0}));
+    BOOST_CHECK(!txospender_index.FindSpender({spend.GetHash(), 0}));
+    BOOST_CHECK(txospender_index.FindSpender(synced_prevout));
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification. The BlockUntilSyncedToCurrentChain()
+    // call above is sufficient to ensure this, but the
+    // SyncWithValidationInterfaceQueue() call below is also needed to ensure
+    // TSAN always sees the test thread waiting for the notification thread, and
+    // avoid potential false positive reports.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // Shutdown sequence (c.f. Shutdown() in init.cpp)
+    txospender_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/lru_cache.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(util_lru_cache_tests)
+
+BOOST_AUTO_TEST_CASE(lru_cache_eviction)
+{
+    LRUCache<int, std::string> cache{/*max_cost=*/3};
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    cache.Put(3, "three");
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+    BOOST_CHECK_EQUAL(cache.Cost(), 3U);
+
+    // Using 1 makes 2 the least recently used entry.
+    BOOST_CHECK_EQUAL(cache.Get(1).value(), "one");
+    cache.Put(4, "four");
+    BOOST_CHECK(!cache.Contains(2));
+    BOOST_CHECK(!cache.Get(2));
+    BOOST_CHECK(cache.Contains(1));
+    BOOST_CHECK(cache.Contains(3));
+    BOOST_CHECK(cache.Contains(4));
+
+    // Replacing an entry does not evict others.
+    cache.Put(3, "THREE");
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+    BOOST_CHECK_EQUAL(cache.Get(3).value(), "THREE");
+
+    BOOST_CHECK(cache.Erase(1));
+    BOOST_CHECK(!cache.Erase(1));
+    BOOST_CHECK_EQUAL(cache.Size(), 2U);
+    BOOST_CHECK_EQUAL(cache.Cost(), 2U);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK_EQUAL(cache.Cost(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(lru_cache_cost)
+{
+    LRUCache<int, int> cache{/*max_cost=*/100};
+    cache.Put(1, 1, /*cost=*/40);
+    cache.Put(2, 2, /*cost=*/40);
+    BOOST_CHECK_EQUAL(cache.Cost(), 80U);
+
+    // Making room for an expensive entry evicts as many entries as needed.
+    cache.Put(3, 3, /*cost=*/90);
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK_EQUAL(cache.Cost(), 90U);
+    BOOST_CHECK(cache.Contains(3));
+
+    // Entries costing more than the maximum are not inserted, and replace
+    // nothing.
+    cache.Put(4, 4, /*cost=*/101);
+    BOOST_CHECK(!cache.Contains(4));
+    BOOST_CHECK(cache.Contains(3));
+
+    // Lowering the maximum cost evicts entries.
+    cache.Put(5, 5, /*cost=*/10);
+    cache.SetMaxCost(50);
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK(cache.Contains(5));
+    BOOST_CHECK_EQUAL(cache.MaxCost(), 50U);
+
+    // A zero sized cache holds nothing.
+    cache.SetMaxCost(0);
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    cache.Put(6, 6, /*cost=*/1);
+    BOOST_CHECK(!cache.Contains(6));
+}
+
+BOOST_AUTO_TEST_CASE(lru_cache_get_updates_recency)
+{
+    LRUCache<int, int> cache{/*max_cost=*/2};
+    cache.Put(1, 10);
+    cache.Put(2, 20);
+    BOOST_CHECK_EQUAL(cache.Get(1).value(), 10);
+    cache.Put(3, 30);
+    BOOST_CHECK(cache.Contains(1));
+    BOOST_CHECK(!cache.Contains(2));
+    BOOST_CHECK_EQUAL(cache.Get(1).value(), 10);
+    cache.Put(4, 40);
+    BOOST_CHECK(cache.Contains(1));
+    BOOST_CHECK(!cache.Contains(3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
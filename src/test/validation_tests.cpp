@@ -13,6 +13,7 @@
 #include <util/chaintype.h>
 #include <validation.h>
 
+#include <ios>
 #include <string>
 
 #include <test/util/setup_common.h>
@@ -360,4 +361,38 @@ BOOST_AUTO_TEST_CASE(block_malleation)
     }
 }
 
+BOOST_AUTO_TEST_CASE(block_loader)
+{
+    const CBlock& genesis{Params().GenesisBlock()};
+    CBlock invalid{genesis};
+    invalid.hashMerkleRoot = uint256::ONE;
+
+    for (const int threads : {0, 2}) {
+        BlockLoader loader{Params().GetConsensus(), threads};
+        BOOST_CHECK_EQUAL(loader.HasThreads(), threads > 0);
+        const auto loaded{loader.Add([&](CBlock& block) { block = genesis; return true; })};
+        const auto not_checked{loader.Add([&](CBlock& block) { block = invalid; return true; })};
+        const auto failed{loader.Add([](CBlock&) { return false; })};
+        const auto threw{loader.Add([](CBlock&) -> bool { throw std::ios_base::failure{"end of data"}; })};
+
+        loader.Wait(*loaded);
+        BOOST_REQUIRE(loaded->block);
+        BOOST_CHECK_EQUAL(loaded->block->GetHash(), genesis.GetHash());
+        // Blocks are checked as they are loaded.
+        BOOST_CHECK(loaded->block->fChecked);
+
+        // Blocks failing CheckBlock() are loaded, and left to the validating thread to reject.
+        loader.Wait(*not_checked);
+        BOOST_REQUIRE(not_checked->block);
+        BOOST_CHECK(!not_checked->block->fChecked);
+
+        loader.Wait(*failed);
+        BOOST_CHECK(!failed->block);
+        BOOST_CHECK(failed->error.empty());
+        loader.Wait(*threw);
+        BOOST_CHECK(!threw->block);
+        BOOST_CHECK_EQUAL(threw->error, std::ios_base::failure{"end of data"}.what());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
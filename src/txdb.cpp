@@ -48,8 +48,11 @@ struct CoinEntry {
 
 CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_db_params{std::move(db_params)},
-    m_options{std::move(options)},
-    m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
+    m_options{std::move(options)}
+{
+    m_db_params.read_threads = m_options.read_threads;
+    m_db = std::make_unique<CDBWrapper>(m_db_params);
+}
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
@@ -69,6 +72,16 @@ bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return m_db->Read(CoinEntry(&outpoint), coin);
 }
 
+void CCoinsViewDB::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const
+{
+    std::vector<CoinEntry> entries;
+    entries.reserve(outpoints.size());
+    for (const COutPoint& outpoint : outpoints) {
+        entries.emplace_back(&outpoint);
+    }
+    m_db->ReadMany(entries, coins);
+}
+
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
     return m_db->Exists(CoinEntry(&outpoint));
 }
@@ -174,6 +187,9 @@ private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
+    //! Cache the key of the current record
+    void CacheKey();
+
     friend class CCoinsViewDB;
 };
 
@@ -185,15 +201,34 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        only need read operations on it, use a const-cast to get around
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
-    // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    i->CacheKey();
+    return i;
+}
+
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewDB::Cursors(Span<const Txid> starts) const
+{
+    const uint256 best_block{GetBestBlock()};
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    cursors.reserve(starts.size());
+    auto iterators{const_cast<CDBWrapper&>(*m_db).NewIterators(starts.size())};
+    for (size_t i = 0; i < starts.size(); ++i) {
+        auto cursor{std::make_unique<CCoinsViewDBCursor>(iterators[i].release(), best_block)};
+        const COutPoint start{starts[i], 0};
+        cursor->pcursor->Seek(CoinEntry{&start});
+        cursor->CacheKey();
+        cursors.push_back(std::move(cursor));
+    }
+    return cursors;
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
+        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = entry.key;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -219,10 +254,5 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    CacheKey();
 }
@@ -25,6 +25,10 @@ class uint256;
 static const int64_t nDefaultDbCache = 450;
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -dbreadthreads default
+static constexpr int DEFAULT_DB_READ_THREADS{4};
+//! max. -dbreadthreads
+static constexpr int MAX_DB_READ_THREADS{16};
 //! min. -dbcache (MiB)
 static const int64_t nMinDbCache = 4;
 //! Max memory allocated to block tree DB specific cache, if no -txindex (MiB)
@@ -45,6 +49,9 @@ struct CoinsViewOptions {
     //! If non-zero, randomly exit when the database is flushed with (1/ratio)
     //! probability.
     int simulate_crash_ratio = 0;
+    //! Number of threads looking up coins in the database along with the
+    //! thread fetching them, when many coins are fetched at once.
+    int read_threads = DEFAULT_DB_READ_THREADS;
 };
 
 /** CCoinsView backed by the coin database (chainstate/) */
@@ -58,11 +65,13 @@ public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(Span<const Txid> starts) const override;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -73,6 +82,8 @@ public:
 
     //! @returns filesystem path to on-disk storage or std::nullopt if in memory.
     std::optional<fs::path> StoragePath() { return m_db->StoragePath(); }
+
+    DBCompactionStats GetCompactionStats() const { return m_db->GetCompactionStats(); }
 };
 
 #endif // BITCOIN_TXDB_H
@@ -20,6 +20,7 @@
 #include <util/feefrac.h>
 #include <util/moneystr.h>
 #include <util/overflow.h>
+#include <util/rbf.h>
 #include <util/result.h>
 #include <util/time.h>
 #include <util/trace.h>
@@ -91,6 +92,7 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendan
             mapTx.modify(mapTx.iterator_to(descendant), [=](CTxMemPoolEntry& e) {
               e.UpdateAncestorState(updateIt->GetTxSize(), updateIt->GetModifiedFee(), 1, updateIt->GetSigOpCost());
             });
+            UpdateFeerateHistogram(mapTx.iterator_to(descendant));
             // Don't directly remove the transaction here -- doing so would
             // invalidate iterators in cachedDescendants. Mark it for removal
             // by inserting into descendants_to_remove.
@@ -105,6 +107,7 @@ void CTxMemPool::UpdateForDescendants(txiter updateIt, cacheMap& cachedDescendan
 void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256>& vHashesToUpdate)
 {
     AssertLockHeld(cs);
+    ++m_snapshot_epoch;
     // For each entry in vHashesToUpdate, store the set of in-mempool, but not
     // in-vHashesToUpdate transactions, so that we don't have to recalculate
     // descendants when we come across a previously seen entry.
@@ -312,6 +315,25 @@ void CTxMemPool::UpdateEntryForAncestors(txiter it, const setEntries &setAncesto
     mapTx.modify(it, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(updateSize, updateFee, updateCount, updateSigOpsCost); });
 }
 
+static size_t FeerateHistogramBucket(const CTxMemPoolEntry& entry)
+{
+    // Use the lower of the transaction's own and its ancestor package's
+    // modified feerate, like the ancestor_score index does.
+    const FeeFrac own{entry.GetModifiedFee(), entry.GetTxSize()};
+    const FeeFrac with_ancestors{entry.GetModFeesWithAncestors(), static_cast<int32_t>(entry.GetSizeWithAncestors())};
+    const FeeFrac& score{with_ancestors << own ? with_ancestors : own};
+    return FeerateHistogram::BucketIndex(score.fee, score.size);
+}
+
+void CTxMemPool::UpdateFeerateHistogram(txiter it)
+{
+    const size_t bucket{FeerateHistogramBucket(*it)};
+    if (bucket == it->m_feerate_bucket) return;
+    m_feerate_histogram.Remove(it->m_feerate_bucket, it->GetFee(), it->GetTxSize());
+    m_feerate_histogram.Add(bucket, it->GetFee(), it->GetTxSize());
+    it->m_feerate_bucket = bucket;
+}
+
 void CTxMemPool::UpdateChildrenForRemoval(txiter it)
 {
     const CTxMemPoolEntry::Children& children = it->GetMemPoolChildrenConst();
@@ -340,6 +362,7 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
             int modifySigOps = -removeIt->GetSigOpCost();
             for (txiter dit : setDescendants) {
                 mapTx.modify(dit, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(modifySize, modifyFee, -1, modifySigOps); });
+                UpdateFeerateHistogram(dit);
             }
         }
     }
@@ -471,8 +494,11 @@ void CTxMemPool::addUnchecked(const CTxMemPoolEntry &entry, setEntries &setAnces
     UpdateEntryForAncestors(newit, setAncestors);
 
     nTransactionsUpdated++;
+    ++m_snapshot_epoch;
     totalTxSize += entry.GetTxSize();
     m_total_fee += entry.GetFee();
+    newit->m_feerate_bucket = FeerateHistogramBucket(*newit);
+    m_feerate_histogram.Add(newit->m_feerate_bucket, entry.GetFee(), entry.GetTxSize());
 
     txns_randomized.emplace_back(newit->GetSharedTx());
     newit->idx_randomized = txns_randomized.size() - 1;
@@ -497,6 +523,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
         // notification.
         m_opts.signals->TransactionRemovedFromMempool(it->GetSharedTx(), reason, mempool_sequence);
     }
+    LogEvent({mempool_sequence, it->GetTx().GetHash(), it->GetTx().GetWitnessHash(), reason});
     TRACE5(mempool, removed,
         it->GetTx().GetHash().data(),
         RemovalReasonToString(reason).c_str(),
@@ -523,10 +550,12 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 
     totalTxSize -= it->GetTxSize();
     m_total_fee -= it->GetFee();
+    m_feerate_histogram.Remove(it->m_feerate_bucket, it->GetFee(), it->GetTxSize());
     cachedInnerUsage -= it->DynamicMemoryUsage();
     cachedInnerUsage -= memusage::DynamicUsage(it->GetMemPoolParentsConst()) + memusage::DynamicUsage(it->GetMemPoolChildrenConst());
     mapTx.erase(it);
     nTransactionsUpdated++;
+    ++m_snapshot_epoch;
 }
 
 // Calculates descendants of entry that are not already in setDescendants, and adds to
@@ -665,6 +694,7 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
 
     uint64_t checkTotal = 0;
     CAmount check_total_fee{0};
+    FeerateHistogram check_histogram;
     uint64_t innerUsage = 0;
     uint64_t prev_ancestor_count{0};
 
@@ -673,6 +703,8 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
     for (const auto& it : GetSortedDepthAndScore()) {
         checkTotal += it->GetTxSize();
         check_total_fee += it->GetFee();
+        assert(it->m_feerate_bucket == FeerateHistogramBucket(*it));
+        check_histogram.Add(it->m_feerate_bucket, it->GetFee(), it->GetTxSize());
         innerUsage += it->DynamicMemoryUsage();
         const CTransaction& tx = it->GetTx();
         innerUsage += memusage::DynamicUsage(it->GetMemPoolParentsConst()) + memusage::DynamicUsage(it->GetMemPoolChildrenConst());
@@ -755,6 +787,7 @@ void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendhei
 
     assert(totalTxSize == checkTotal);
     assert(m_total_fee == check_total_fee);
+    assert(m_feerate_histogram == check_histogram);
     assert(innerUsage == cachedInnerUsage);
 }
 
@@ -824,6 +857,138 @@ std::vector<CTxMemPoolEntryRef> CTxMemPool::entryAll() const
     return ret;
 }
 
+/** Copy the fields of a snapshot entry that only depend on the entry itself. */
+static MempoolSnapshot::Entry CopySnapshotEntry(const CTxMemPoolEntry& entry, bool unbroadcast)
+{
+    MempoolSnapshot::Entry ret{
+        .tx = entry.GetSharedTx(),
+        .fee = entry.GetFee(),
+        .modified_fee = entry.GetModifiedFee(),
+        .vsize = entry.GetTxSize(),
+        .weight = entry.GetTxWeight(),
+        .time = entry.GetTime(),
+        .height = entry.GetHeight(),
+        .count_with_ancestors = entry.GetCountWithAncestors(),
+        .size_with_ancestors = entry.GetSizeWithAncestors(),
+        .mod_fees_with_ancestors = entry.GetModFeesWithAncestors(),
+        .count_with_descendants = entry.GetCountWithDescendants(),
+        .size_with_descendants = entry.GetSizeWithDescendants(),
+        .mod_fees_with_descendants = entry.GetModFeesWithDescendants(),
+        .descendant_maximum = 0,
+        .parents = {},
+        .children = {},
+        .bip125_replaceable = false,
+        .unbroadcast = unbroadcast,
+    };
+    ret.parents.reserve(entry.GetMemPoolParentsConst().size());
+    for (const CTxMemPoolEntry& parent : entry.GetMemPoolParentsConst()) {
+        ret.parents.push_back(parent.GetTx().GetHash());
+    }
+    ret.children.reserve(entry.GetMemPoolChildrenConst().size());
+    for (const CTxMemPoolEntry& child : entry.GetMemPoolChildrenConst()) {
+        ret.children.push_back(child.GetTx().GetHash());
+    }
+    return ret;
+}
+
+MempoolSnapshot::Entry CTxMemPool::MakeSnapshotEntry(const CTxMemPoolEntry& entry) const
+{
+    AssertLockHeld(cs);
+    MempoolSnapshot::Entry ret{CopySnapshotEntry(entry, IsUnbroadcastTx(entry.GetTx().GetHash()))};
+    ret.bip125_replaceable = SignalsOptInRBF(entry.GetTx());
+    for (txiter ancestor : AssumeCalculateMemPoolAncestors(__func__, entry, Limits::NoLimits(), /*fSearchForParents=*/false)) {
+        ret.bip125_replaceable |= SignalsOptInRBF(ancestor->GetTx());
+    }
+    ret.descendant_maximum = CalculateDescendantMaximum(mapTx.iterator_to(entry));
+    return ret;
+}
+
+std::shared_ptr<const MempoolSnapshot> CTxMemPool::GetCurrentSnapshot() const
+{
+    const uint64_t epoch{m_snapshot_epoch.load()};
+    LOCK(m_snapshot_mutex);
+    if (m_snapshot && m_snapshot->epoch == epoch) return m_snapshot;
+    return nullptr;
+}
+
+std::shared_ptr<const MempoolSnapshot> CTxMemPool::GetSnapshot() const
+{
+    if (auto snapshot{GetCurrentSnapshot()}) return snapshot;
+
+    LOCK(cs);
+    // Another reader may have published a snapshot while we were waiting for cs.
+    if (auto snapshot{GetCurrentSnapshot()}) return snapshot;
+
+    auto snapshot{std::make_shared<MempoolSnapshot>()};
+    snapshot->epoch = m_snapshot_epoch.load();
+    snapshot->sequence = m_sequence_number;
+    snapshot->total_tx_size = totalTxSize;
+    snapshot->total_fee = m_total_fee;
+    snapshot->entries.reserve(mapTx.size());
+    snapshot->positions.reserve(mapTx.size());
+    // Parents are sorted before their children, so the ancestor-derived fields
+    // can be computed from the parents' entries instead of walking all ancestors.
+    for (const auto& it : GetSortedDepthAndScore()) {
+        MempoolSnapshot::Entry entry{CopySnapshotEntry(*it, IsUnbroadcastTx(it->GetTx().GetHash()))};
+        entry.bip125_replaceable = SignalsOptInRBF(*entry.tx);
+        if (entry.parents.empty()) entry.descendant_maximum = entry.count_with_descendants;
+        for (const Txid& parent_txid : entry.parents) {
+            const MempoolSnapshot::Entry& parent{*Assert(snapshot->Find(parent_txid))};
+            entry.bip125_replaceable |= parent.bip125_replaceable;
+            entry.descendant_maximum = std::max(entry.descendant_maximum, parent.descendant_maximum);
+        }
+        snapshot->positions.emplace(entry.tx->GetHash(), snapshot->entries.size());
+        snapshot->entries.push_back(std::move(entry));
+    }
+
+    LOCK(m_snapshot_mutex);
+    m_snapshot = snapshot;
+    return snapshot;
+}
+
+std::optional<MempoolSnapshot::Entry> CTxMemPool::GetSnapshotEntry(const Txid& txid) const
+{
+    if (const auto snapshot{GetCurrentSnapshot()}) {
+        const MempoolSnapshot::Entry* entry{snapshot->Find(txid)};
+        if (!entry) return std::nullopt;
+        return *entry;
+    }
+
+    LOCK(cs);
+    const CTxMemPoolEntry* entry{GetEntry(txid)};
+    if (!entry) return std::nullopt;
+    return MakeSnapshotEntry(*entry);
+}
+
+void CTxMemPool::LogEvent(MempoolEvent event)
+{
+    AssertLockHeld(cs);
+    if (m_opts.event_log_size == 0) return;
+    if (m_event_log.size() >= m_opts.event_log_size) m_event_log.pop_front();
+    m_event_log.push_back(std::move(event));
+}
+
+uint64_t CTxMemPool::LogTransactionAdded(const CTransaction& tx)
+{
+    AssertLockHeld(cs);
+    const uint64_t sequence{GetAndIncrementSequence()};
+    LogEvent({sequence, tx.GetHash(), tx.GetWitnessHash(), std::nullopt});
+    return sequence;
+}
+
+std::optional<std::vector<MempoolEvent>> CTxMemPool::GetEventsSince(uint64_t sequence) const
+{
+    AssertLockHeld(cs);
+    // A sequence number ahead of ours was handed out by a previous run.
+    if (sequence > m_sequence_number) return std::nullopt;
+    // Only the oldest events are ever dropped from the log.
+    const uint64_t oldest{m_event_log.empty() ? m_sequence_number : m_event_log.front().sequence};
+    if (sequence < oldest) return std::nullopt;
+    const auto it{std::lower_bound(m_event_log.begin(), m_event_log.end(), sequence,
+                                   [](const MempoolEvent& event, uint64_t seq) { return event.sequence < seq; })};
+    return std::vector<MempoolEvent>(it, m_event_log.end());
+}
+
 std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
 {
     LOCK(cs);
@@ -883,6 +1048,7 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
         txiter it = mapTx.find(hash);
         if (it != mapTx.end()) {
             mapTx.modify(it, [&nFeeDelta](CTxMemPoolEntry& e) { e.UpdateModifiedFee(nFeeDelta); });
+            UpdateFeerateHistogram(it);
             // Now update all ancestors' modified fees with descendants
             auto ancestors{AssumeCalculateMemPoolAncestors(__func__, *it, Limits::NoLimits(), /*fSearchForParents=*/false)};
             for (txiter ancestorIt : ancestors) {
@@ -894,8 +1060,10 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
             setDescendants.erase(it);
             for (txiter descendantIt : setDescendants) {
                 mapTx.modify(descendantIt, [=](CTxMemPoolEntry& e){ e.UpdateAncestorState(0, nFeeDelta, 0, 0); });
+                UpdateFeerateHistogram(descendantIt);
             }
             ++nTransactionsUpdated;
+            ++m_snapshot_epoch;
         }
         if (delta == 0) {
             mapDeltas.erase(hash);
@@ -1012,6 +1180,34 @@ bool CCoinsViewMemPool::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return base->GetCoin(outpoint, coin);
 }
 
+void CCoinsViewMemPool::GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const
+{
+    coins.assign(outpoints.size(), std::nullopt);
+    std::vector<COutPoint> base_outpoints;
+    std::vector<size_t> base_indices;
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        const COutPoint& outpoint{outpoints[i]};
+        // As in GetCoin, coins of the package and the mempool take precedence over those of base.
+        if (auto it = m_temp_added.find(outpoint); it != m_temp_added.end()) {
+            coins[i] = it->second;
+        } else if (CTransactionRef ptx = mempool.get(outpoint.hash)) {
+            if (outpoint.n < ptx->vout.size()) {
+                coins[i] = Coin(ptx->vout[outpoint.n], MEMPOOL_HEIGHT, false);
+                m_non_base_coins.emplace(outpoint);
+            }
+        } else {
+            base_outpoints.push_back(outpoint);
+            base_indices.push_back(i);
+        }
+    }
+    if (base_outpoints.empty()) return;
+    std::vector<std::optional<Coin>> base_coins;
+    base->GetCoins(base_outpoints, base_coins);
+    for (size_t i = 0; i < base_indices.size(); ++i) {
+        coins[base_indices[i]] = std::move(base_coins[i]);
+    }
+}
+
 void CCoinsViewMemPool::PackageAddTransaction(const CTransactionRef& tx)
 {
     for (unsigned int n = 0; n < tx->vout.size(); ++n) {
@@ -1036,6 +1232,7 @@ void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked)
 
     if (m_unbroadcast_txids.erase(txid))
     {
+        ++m_snapshot_epoch;
         LogDebug(BCLog::MEMPOOL, "Removed %i from set of unbroadcast txns%s\n", txid.GetHex(), (unchecked ? " before confirmation that txn was sent out" : ""));
     }
 }
@@ -1191,6 +1388,18 @@ uint64_t CTxMemPool::CalculateDescendantMaximum(txiter entry) const {
 }
 
 void CTxMemPool::GetTransactionAncestry(const uint256& txid, size_t& ancestors, size_t& descendants, size_t* const ancestorsize, CAmount* const ancestorfees) const {
+    if (const auto snapshot{GetCurrentSnapshot()}) {
+        const MempoolSnapshot::Entry* entry{snapshot->Find(Txid::FromUint256(txid))};
+        ancestors = descendants = 0;
+        if (entry) {
+            ancestors = entry->count_with_ancestors;
+            if (ancestorsize) *ancestorsize = entry->size_with_ancestors;
+            if (ancestorfees) *ancestorfees = entry->mod_fees_with_ancestors;
+            descendants = entry->descendant_maximum;
+        }
+        return;
+    }
+
     LOCK(cs);
     auto it = mapTx.find(txid);
     ancestors = descendants = 0;
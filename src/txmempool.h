@@ -15,6 +15,7 @@
 #include <kernel/mempool_options.h>        // IWYU pragma: export
 #include <kernel/mempool_removal_reason.h> // IWYU pragma: export
 #include <policy/feerate.h>
+#include <policy/feerate_histogram.h>
 #include <policy/packages.h>
 #include <primitives/transaction.h>
 #include <sync.h>
@@ -32,11 +33,15 @@
 #include <boost/multi_index_container.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -227,6 +232,69 @@ struct TxMempoolInfo
     int64_t nFeeDelta;
 };
 
+/**
+ * Immutable copy of the metadata of all mempool entries, taken while the
+ * mempool was consistent. A published snapshot is never modified, so it can be
+ * shared between threads and queried without holding CTxMemPool::cs.
+ */
+struct MempoolSnapshot
+{
+    struct Entry
+    {
+        CTransactionRef tx;
+        CAmount fee;
+        CAmount modified_fee;
+        int32_t vsize;
+        int32_t weight;
+        std::chrono::seconds time;
+        unsigned int height;
+        uint64_t count_with_ancestors;
+        int64_t size_with_ancestors;
+        CAmount mod_fees_with_ancestors;
+        uint64_t count_with_descendants;
+        int64_t size_with_descendants;
+        CAmount mod_fees_with_descendants;
+        /** See CTxMemPool::CalculateDescendantMaximum() */
+        uint64_t descendant_maximum;
+        std::vector<Txid> parents;
+        std::vector<Txid> children;
+        /** Whether this transaction or one of its in-mempool ancestors signals BIP125 replaceability */
+        bool bip125_replaceable;
+        bool unbroadcast;
+    };
+
+    /** Value of the mempool's snapshot epoch when this snapshot was taken */
+    uint64_t epoch{0};
+    /** Mempool sequence number when this snapshot was taken */
+    uint64_t sequence{0};
+    uint64_t total_tx_size{0};
+    CAmount total_fee{0};
+    /** All entries, sorted by depth and score like CTxMemPool::entryAll() */
+    std::vector<Entry> entries;
+    std::unordered_map<Txid, size_t, SaltedTxidHasher> positions;
+
+    const Entry* Find(const Txid& txid) const
+    {
+        const auto it{positions.find(txid)};
+        return it == positions.end() ? nullptr : &entries[it->second];
+    }
+};
+
+/**
+ * A transaction entering or leaving the mempool, with the mempool sequence
+ * number it was assigned. These are the same numbers reported by the
+ * TransactionAddedToMempool and TransactionRemovedFromMempool notifications,
+ * but removals for blocks are included as well.
+ */
+struct MempoolEvent
+{
+    uint64_t sequence;
+    Txid txid;
+    Wtxid wtxid;
+    /** Why the transaction was removed, or nullopt if it was added */
+    std::optional<MemPoolRemovalReason> removal_reason;
+};
+
 /**
  * CTxMemPool stores valid-according-to-the-current-best-chain transactions
  * that may be included in the next block.
@@ -308,17 +376,30 @@ protected:
     uint64_t totalTxSize GUARDED_BY(cs){0};      //!< sum of all mempool tx's virtual sizes. Differs from serialized tx size since witness data is discounted. Defined in BIP 141.
     CAmount m_total_fee GUARDED_BY(cs){0};       //!< sum of all mempool tx's fees (NOT modified fee)
     uint64_t cachedInnerUsage GUARDED_BY(cs){0}; //!< sum of dynamic memory usage of all the map elements (NOT the maps themselves)
+    FeerateHistogram m_feerate_histogram GUARDED_BY(cs); //!< vsize of all mempool tx's by ancestor score
 
     mutable int64_t lastRollingFeeUpdate GUARDED_BY(cs){GetTime()};
     mutable bool blockSinceLastRollingFeeBump GUARDED_BY(cs){false};
     mutable double rollingMinimumFeeRate GUARDED_BY(cs){0}; //!< minimum fee to get into the pool, decreases exponentially
     mutable Epoch m_epoch GUARDED_BY(cs){};
 
+    // Incremented, while holding cs, on every change that is visible in a
+    // MempoolSnapshot. A published snapshot taken at the current epoch can be
+    // used by readers without locking cs.
+    std::atomic<uint64_t> m_snapshot_epoch{0};
+    mutable Mutex m_snapshot_mutex;
+    mutable std::shared_ptr<const MempoolSnapshot> m_snapshot GUARDED_BY(m_snapshot_mutex);
+
     // In-memory counter for external mempool tracking purposes.
     // This number is incremented once every time a transaction
     // is added or removed from the mempool for any reason.
     mutable uint64_t m_sequence_number GUARDED_BY(cs){1};
 
+    // The last m_opts.event_log_size additions and removals, in sequence order.
+    std::deque<MempoolEvent> m_event_log GUARDED_BY(cs);
+
+    void LogEvent(MempoolEvent event) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     void trackPackageRemoved(const CFeeRate& rate) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     bool m_load_tried GUARDED_BY(cs){false};
@@ -630,7 +711,7 @@ public:
      * When ancestors is non-zero (ie, the transaction itself is in the mempool),
      * ancestorsize and ancestorfees will also be set to the appropriate values.
      */
-    void GetTransactionAncestry(const uint256& txid, size_t& ancestors, size_t& descendants, size_t* ancestorsize = nullptr, CAmount* ancestorfees = nullptr) const;
+    void GetTransactionAncestry(const uint256& txid, size_t& ancestors, size_t& descendants, size_t* ancestorsize = nullptr, CAmount* ancestorfees = nullptr) const EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
 
     /**
      * @returns true if an initial attempt to load the persisted mempool was made, regardless of
@@ -662,6 +743,15 @@ public:
         return m_total_fee;
     }
 
+    /** Histogram of all mempool transactions by ancestor score (the lower of
+     * their own and their ancestor package's modified feerate), maintained
+     * incrementally as transactions are added, removed or prioritised. */
+    const FeerateHistogram& GetFeerateHistogram() const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        AssertLockHeld(cs);
+        return m_feerate_histogram;
+    }
+
     bool exists(const GenTxid& gtxid) const
     {
         LOCK(cs);
@@ -685,6 +775,27 @@ public:
     TxMempoolInfo info_for_relay(const GenTxid& gtxid, uint64_t last_sequence) const;
 
     std::vector<CTxMemPoolEntryRef> entryAll() const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    /** Copy the metadata of a single mempool entry. */
+    MempoolSnapshot::Entry MakeSnapshotEntry(const CTxMemPoolEntry& entry) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    /** Counter that changes whenever the mempool changes in a way visible in a
+     * MempoolSnapshot. Other caches of mempool data can use it for invalidation. */
+    uint64_t GetSnapshotEpoch() const { return m_snapshot_epoch.load(); }
+
+    /** Return the published snapshot if it reflects the current state of the
+     * mempool, without locking cs. Returns nullptr if the mempool changed
+     * since the last snapshot was taken. */
+    std::shared_ptr<const MempoolSnapshot> GetCurrentSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
+
+    /** Return a snapshot of the current mempool. If the published snapshot is
+     * stale, a new one is taken under cs and published for other readers, so
+     * that cs is only locked once per batch of mempool changes. */
+    std::shared_ptr<const MempoolSnapshot> GetSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
+
+    /** Look up a single entry in the current snapshot, falling back to
+     * locking cs if the snapshot is stale. Never takes a new snapshot. */
+    std::optional<MempoolSnapshot::Entry> GetSnapshotEntry(const Txid& txid) const EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
     std::vector<TxMempoolInfo> infoAll() const;
 
     size_t DynamicMemoryUsage() const;
@@ -695,7 +806,7 @@ public:
         LOCK(cs);
         // Sanity check the transaction is in the mempool & insert into
         // unbroadcast set.
-        if (exists(GenTxid::Txid(txid))) m_unbroadcast_txids.insert(txid);
+        if (exists(GenTxid::Txid(txid)) && m_unbroadcast_txids.insert(txid).second) ++m_snapshot_epoch;
     };
 
     /** Removes a transaction from the unbroadcast set */
@@ -724,6 +835,19 @@ public:
         return m_sequence_number;
     }
 
+    /** Assign the next sequence number to a transaction that was just added to
+     * the mempool and record it in the event log. */
+    uint64_t LogTransactionAdded(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    /**
+     * Return the logged events with a sequence number of at least `sequence`.
+     * Returns nullopt if some of these events were already dropped from the
+     * event log, or if `sequence` is ahead of GetSequence() (e.g. because it
+     * was obtained before a restart). The caller then has to resynchronize
+     * with the full mempool contents.
+     */
+    std::optional<std::vector<MempoolEvent>> GetEventsSince(uint64_t sequence) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     /**
      * Calculate the sorted chunks for the old and new mempool relating to the
      * clusters that would be affected by a potential replacement transaction.
@@ -787,6 +911,9 @@ private:
     void UpdateForRemoveFromMempool(const setEntries &entriesToRemove, bool updateDescendants) EXCLUSIVE_LOCKS_REQUIRED(cs);
     /** Sever link between specified transaction and direct children. */
     void UpdateChildrenForRemoval(txiter entry) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    /** Move an entry to a different feerate histogram bucket after its
+     *  modified fee or ancestor state changed. */
+    void UpdateFeerateHistogram(txiter entry) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     /** Before calling removeUnchecked for a given transaction,
      *  UpdateForRemoveFromMempool must be called on the entire (dependent) set
@@ -852,6 +979,8 @@ public:
     /** GetCoin, returning whether it exists and is not spent. Also updates m_non_base_coins if the
      * coin is not fetched from base. */
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    /** GetCoins, looking up the coins not fetched from the mempool with a single call to base. */
+    void GetCoins(Span<const COutPoint> outpoints, std::vector<std::optional<Coin>>& coins) const override;
     /** Add the coins created by this transaction. These coins are only temporarily stored in
      * m_temp_added and cannot be flushed to the back end. Only used for package validation. */
     void PackageAddTransaction(const CTransactionRef& tx);
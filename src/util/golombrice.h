@@ -7,9 +7,15 @@
 
 #include <util/fastrange.h>
 
+#include <crypto/common.h>
+#include <span.h>
 #include <streams.h>
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <ios>
+#include <vector>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +48,172 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Encoder of a sequence of Golomb-Rice coded values, appended to a byte vector.
+ *
+ * Produces the same encoding as GolombRiceEncode on a BitStreamWriter, but
+ * accumulates 64 bits of output at a time and writes the unary-coded quotient
+ * and the remainder of a value together.
+ */
+class GolombRiceEncoder
+{
+private:
+    std::vector<unsigned char>& m_out;
+
+    /// Bits not written to m_out yet, aligned to the most significant bit.
+    /// The bits following the first m_bits are zero. Never full.
+    uint64_t m_buffer{0};
+    int m_bits{0};
+
+    /** Append the 1 to 64 least significant bits of data. */
+    void Write(uint64_t data, int nbits)
+    {
+        if (nbits < 64) data &= (uint64_t{1} << nbits) - 1;
+        const int free{64 - m_bits};
+        if (nbits < free) {
+            m_buffer |= data << (free - nbits);
+            m_bits += nbits;
+            return;
+        }
+        const int rest{nbits - free};
+        m_buffer |= data >> rest;
+        unsigned char word[8];
+        WriteBE64(word, m_buffer);
+        m_out.insert(m_out.end(), word, word + 8);
+        m_buffer = rest == 0 ? 0 : data << (64 - rest);
+        m_bits = rest;
+    }
+
+public:
+    explicit GolombRiceEncoder(std::vector<unsigned char>& out) : m_out{out} {}
+
+    void Encode(uint8_t P, uint64_t x)
+    {
+        uint64_t q = x >> P;
+        if (P < 64 && q <= 63U - P) {
+            // Quotient as unary-encoded, q 1's followed by one 0, then the remainder in P bits.
+            const uint64_t remainder{P ? x & (~uint64_t{0} >> (64 - P)) : 0};
+            Write(((~uint64_t{0} << 1) << P) | remainder, static_cast<int>(q) + 1 + P);
+            return;
+        }
+        while (q > 0) {
+            const int nbits = q <= 64 ? static_cast<int>(q) : 64;
+            Write(~uint64_t{0}, nbits);
+            q -= nbits;
+        }
+        Write(0, 1);
+        if (P) Write(x, P);
+    }
+
+    /** Write the remaining bits, padding the last byte with zeros. */
+    void Flush()
+    {
+        unsigned char word[8];
+        WriteBE64(word, m_buffer);
+        m_out.insert(m_out.end(), word, word + (m_bits + 7) / 8);
+        m_buffer = 0;
+        m_bits = 0;
+    }
+};
+
+/**
+ * Decoder for a sequence of Golomb-Rice coded values in a byte span.
+ *
+ * Decodes the same values as GolombRiceDecode on a BitStreamReader, but
+ * buffers 64 bits of input at a time and counts the unary-coded quotient of a
+ * value with a single instruction rather than bit by bit.
+ */
+class GolombRiceDecoder
+{
+private:
+    Span<const unsigned char> m_data;
+
+    /// Bits loaded from m_data and not returned yet, aligned to the most
+    /// significant bit. The bits following the first m_bits are zero.
+    uint64_t m_buffer{0};
+    int m_bits{0};
+
+    void Refill()
+    {
+        if (m_bits > 56) return;
+        if (m_data.size() >= 8) {
+            const int nbytes{(64 - m_bits) / 8};
+            const int bits{m_bits + 8 * nbytes};
+            uint64_t word{ReadBE64(m_data.data()) >> m_bits};
+            if (bits < 64) word &= ~(~uint64_t{0} >> bits);
+            m_buffer |= word;
+            m_bits = bits;
+            m_data = m_data.subspan(nbytes);
+            return;
+        }
+        while (m_bits <= 56 && !m_data.empty()) {
+            m_buffer |= uint64_t{m_data.front()} << (56 - m_bits);
+            m_bits += 8;
+            m_data = m_data.subspan(1);
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_buffer = nbits == 64 ? 0 : m_buffer << nbits;
+        m_bits -= nbits;
+    }
+
+public:
+    explicit GolombRiceDecoder(Span<const unsigned char> data) : m_data{data} {}
+
+    /** Read the specified number of bits, returned in the nbits least significant bits. */
+    uint64_t Read(int nbits)
+    {
+        uint64_t data{0};
+        while (nbits > 0) {
+            Refill();
+            if (m_bits == 0) {
+                throw std::ios_base::failure("GolombRiceDecoder::Read(): end of data");
+            }
+            const int bits{std::min(m_bits, nbits)};
+            data = (bits == 64 ? 0 : data << bits) | (m_buffer >> (64 - bits));
+            Consume(bits);
+            nbits -= bits;
+        }
+        return data;
+    }
+
+    uint64_t Decode(uint8_t P)
+    {
+        Refill();
+
+        // Fast path: the whole value is in the buffer.
+        const int ones{std::countl_one(m_buffer)};
+        if (P < 64 && ones + 1 + P <= m_bits) {
+            const uint64_t rest{(m_buffer << ones) << 1};
+            m_buffer = rest << P;
+            m_bits -= ones + 1 + P;
+            return (uint64_t{static_cast<unsigned>(ones)} << P) + ((rest >> 1) >> (63 - P));
+        }
+
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q{0};
+        while (true) {
+            Refill();
+            if (m_bits == 0) {
+                throw std::ios_base::failure("GolombRiceDecoder::Decode(): end of data");
+            }
+            const int ones{std::countl_one(m_buffer)};
+            if (ones < m_bits) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            q += m_bits;
+            Consume(m_bits);
+        }
+
+        return (q << P) + Read(P);
+    }
+
+    /** Whether all bytes of the input were read, i.e. only padding bits of the last byte may remain. */
+    bool Exhausted() const { return m_data.empty() && m_bits < 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
@@ -0,0 +1,106 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_LRU_CACHE_H
+#define BITCOIN_UTIL_LRU_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * A map with a bounded total cost that evicts the least recently used
+ * entries to make room for new ones.
+ *
+ * Each entry has a cost given on insertion, e.g. its size in bytes, and the
+ * sum of the costs of all entries never exceeds the maximum cost. Entries
+ * costing more than the maximum cost are not inserted.
+ *
+ * This class is not thread-safe.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache
+{
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+    using List = std::list<Entry>;
+
+    /** Entries, from the most to the least recently used */
+    List m_entries;
+    std::unordered_map<Key, typename List::iterator, Hash> m_map;
+    size_t m_max_cost;
+    size_t m_cost{0};
+
+    void EvictUntil(size_t max_cost)
+    {
+        while (m_cost > max_cost) {
+            const Entry& last{m_entries.back()};
+            m_cost -= last.cost;
+            m_map.erase(last.key);
+            m_entries.pop_back();
+        }
+    }
+
+public:
+    explicit LRUCache(size_t max_cost, const Hash& hash = Hash{}) : m_map(0, hash), m_max_cost{max_cost} {}
+
+    /** Return a copy of the value of an entry and mark it as the most recently used. */
+    std::optional<Value> Get(const Key& key)
+    {
+        const auto it{m_map.find(key)};
+        if (it == m_map.end()) return std::nullopt;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->value;
+    }
+
+    bool Contains(const Key& key) const { return m_map.count(key) > 0; }
+
+    /** Insert or replace an entry, evicting the least recently used ones if needed. */
+    void Put(const Key& key, Value value, size_t cost = 1)
+    {
+        Erase(key);
+        if (cost > m_max_cost) return;
+        EvictUntil(m_max_cost - cost);
+        m_entries.push_front(Entry{key, std::move(value), cost});
+        m_map.emplace(key, m_entries.begin());
+        m_cost += cost;
+    }
+
+    bool Erase(const Key& key)
+    {
+        const auto it{m_map.find(key)};
+        if (it == m_map.end()) return false;
+        m_cost -= it->second->cost;
+        m_entries.erase(it->second);
+        m_map.erase(it);
+        return true;
+    }
+
+    void Clear()
+    {
+        m_entries.clear();
+        m_map.clear();
+        m_cost = 0;
+    }
+
+    /** Change the maximum cost, evicting entries if needed. */
+    void SetMaxCost(size_t max_cost)
+    {
+        m_max_cost = max_cost;
+        EvictUntil(m_max_cost);
+    }
+
+    size_t Size() const { return m_map.size(); }
+    size_t Cost() const { return m_cost; }
+    size_t MaxCost() const { return m_max_cost; }
+};
+
+#endif // BITCOIN_UTIL_LRU_CACHE_H
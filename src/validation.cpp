@@ -58,6 +58,7 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -1421,6 +1422,7 @@ bool MemPoolAccept::SubmitPackage(const ATMPArgs& args, std::vector<Workspace>&
         results.emplace(ws.m_ptx->GetWitnessHash(),
                         MempoolAcceptResult::Success(std::move(m_subpackage.m_replaced_transactions), ws.m_vsize,
                                          ws.m_base_fees, effective_feerate, effective_feerate_wtxids));
+        const uint64_t mempool_sequence{m_pool.LogTransactionAdded(*ws.m_ptx)};
         if (!m_pool.m_opts.signals) continue;
         const CTransaction& tx = *ws.m_ptx;
         const auto tx_info = NewMempoolTransactionInfo(ws.m_ptx, ws.m_base_fees,
@@ -1428,7 +1430,7 @@ bool MemPoolAccept::SubmitPackage(const ATMPArgs& args, std::vector<Workspace>&
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
                                                        m_pool.HasNoInputsOf(tx));
-        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
+        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, mempool_sequence);
     }
     return all_submitted;
 }
@@ -1483,6 +1485,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
         return MempoolAcceptResult::FeeFailure(ws.m_state, CFeeRate(ws.m_modified_fees, ws.m_vsize), {ws.m_ptx->GetWitnessHash()});
     }
 
+    const uint64_t mempool_sequence{m_pool.LogTransactionAdded(*ws.m_ptx)};
     if (m_pool.m_opts.signals) {
         const CTransaction& tx = *ws.m_ptx;
         const auto tx_info = NewMempoolTransactionInfo(ws.m_ptx, ws.m_base_fees,
@@ -1490,7 +1493,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
                                                        args.m_bypass_limits, args.m_package_submission,
                                                        IsCurrentForFeeEstimation(m_active_chainstate),
                                                        m_pool.HasNoInputsOf(tx));
-        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, m_pool.GetAndIncrementSequence());
+        m_pool.m_opts.signals->TransactionAddedToMempool(tx_info, mempool_sequence);
     }
 
     if (!m_subpackage.m_replaced_transactions.empty()) {
@@ -1974,7 +1977,8 @@ void Chainstate::InitCoinsDB(
             .memory_only = in_memory,
             .wipe_data = should_wipe,
             .obfuscate = true,
-            .options = m_chainman.m_options.coins_db},
+            .options = m_chainman.m_options.coins_db,
+            .compact_when_idle = true},
         m_chainman.m_options.coins_view);
 }
 
@@ -2594,6 +2598,22 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
              Ticks<SecondsDouble>(m_chainman.time_forks),
              Ticks<MillisecondsDouble>(m_chainman.time_forks) / m_chainman.num_blocks_total);
 
+    // Fetch the coins spent by the block at once, so that those not cached are
+    // looked up in the database together rather than one at a time below.
+    // Outputs created by the block itself cannot be in the UTXO set yet.
+    {
+        std::unordered_set<uint256, SaltedTxidHasher> block_txids;
+        block_txids.reserve(block.vtx.size());
+        for (const auto& tx : block.vtx) block_txids.insert(tx->GetHash());
+        std::vector<COutPoint> prevouts;
+        for (size_t i = 1; i < block.vtx.size(); ++i) {
+            for (const CTxIn& txin : block.vtx[i]->vin) {
+                if (!block_txids.count(txin.prevout.hash)) prevouts.push_back(txin.prevout);
+            }
+        }
+        view.FetchCoins(prevouts);
+    }
+
     CBlockUndo blockundo;
 
     // Precomputed transaction data pointers must not be invalidated
@@ -3145,11 +3165,20 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     const auto time_1{SteadyClock::now()};
     std::shared_ptr<const CBlock> pthisBlock;
     if (!pblock) {
-        std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
-        if (!m_blockman.ReadBlockFromDisk(*pblockNew, *pindexNew)) {
-            return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
+        if (auto it{m_blocks_loaded_ahead.find(pindexNew)}; it != m_blocks_loaded_ahead.end()) {
+            m_chainman.m_block_loader.Wait(*it->second);
+            pthisBlock = it->second->block;
+            m_blocks_loaded_ahead.erase(it);
+        }
+        if (pthisBlock) {
+            LogDebug(BCLog::BENCH, "  - Using block loaded ahead\n");
+        } else {
+            std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
+            if (!m_blockman.ReadBlockFromDisk(*pblockNew, *pindexNew)) {
+                return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
+            }
+            pthisBlock = pblockNew;
         }
-        pthisBlock = pblockNew;
     } else {
         LogDebug(BCLog::BENCH, "  - Using cached block\n");
         pthisBlock = pblock;
@@ -3308,6 +3337,31 @@ void Chainstate::PruneBlockIndexCandidates() {
     assert(!setBlockIndexCandidates.empty());
 }
 
+void Chainstate::LoadBlocksAhead(const CBlockIndex& pindex_most_work, const CBlock* pblock)
+{
+    AssertLockHeld(cs_main);
+    if (!m_chainman.m_block_loader.HasThreads()) return;
+
+    // Only keep the blocks that are still to be connected next.
+    const int tip_height{m_chain.Height()};
+    std::erase_if(m_blocks_loaded_ahead, [&](const auto& entry) {
+        const CBlockIndex* pindex{entry.first};
+        return pindex->nHeight <= tip_height || pindex_most_work.GetAncestor(pindex->nHeight) != pindex;
+    });
+
+    const int end_height{std::min(tip_height + int{MAX_BLOCKS_LOADED_AHEAD}, pindex_most_work.nHeight)};
+    for (int height = tip_height + 1; height <= end_height; ++height) {
+        const CBlockIndex* pindex{pindex_most_work.GetAncestor(height)};
+        if (m_blocks_loaded_ahead.count(pindex)) continue;
+        if (pindex == &pindex_most_work && pblock) break;
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA)) break;
+        m_blocks_loaded_ahead.emplace(pindex, m_chainman.m_block_loader.Add(
+            [&blockman = m_blockman, pos = pindex->GetBlockPos(), hash = pindex->GetBlockHash()](CBlock& block) {
+                return blockman.ReadBlockFromDisk(block, pos) && block.GetHash() == hash;
+            }));
+    }
+}
+
 /**
  * Try to make some progress towards making pindexMostWork the active block.
  * pblock is either nullptr or a pointer to a CBlock corresponding to pindexMostWork.
@@ -3340,6 +3394,8 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
         fBlocksDisconnected = true;
     }
 
+    LoadBlocksAhead(*pindexMostWork, pblock.get());
+
     // Build list of new blocks to connect (in descending height order).
     std::vector<CBlockIndex*> vpindexToConnect;
     bool fContinue = true;
@@ -5023,6 +5079,77 @@ bool Chainstate::LoadGenesisBlock()
     return true;
 }
 
+BlockLoader::BlockLoader(const Consensus::Params& consensus, int threads)
+    : m_consensus{consensus}
+{
+    for (int i = 0; i < threads; ++i) {
+        m_threads.emplace_back(&util::TraceThread, strprintf("blockload.%i", i), [this] { Loop(); });
+    }
+}
+
+BlockLoader::~BlockLoader()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_work_cv.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void BlockLoader::Load(Job& job) const
+{
+    auto block{std::make_shared<CBlock>()};
+    try {
+        if (!job.load(*block)) return;
+    } catch (const std::exception& e) {
+        job.error = e.what();
+        return;
+    }
+    // CheckBlock() caches its result in the block, so that it is not checked
+    // again by the thread validating it.
+    BlockValidationState state;
+    CheckBlock(*block, state, m_consensus);
+    job.block = std::move(block);
+}
+
+void BlockLoader::Loop()
+{
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        Load(*job);
+        WITH_LOCK(m_mutex, job->done = true);
+        m_done_cv.notify_all();
+    }
+}
+
+std::shared_ptr<BlockLoader::Job> BlockLoader::Add(std::function<bool(CBlock&)> load)
+{
+    auto job{std::make_shared<Job>(std::move(load))};
+    if (!m_threads.empty()) {
+        WITH_LOCK(m_mutex, m_queue.push_back(job));
+        m_work_cv.notify_one();
+    }
+    return job;
+}
+
+void BlockLoader::Wait(Job& job)
+{
+    if (m_threads.empty()) {
+        if (!job.done) {
+            Load(job);
+            job.done = true;
+        }
+        return;
+    }
+    WAIT_LOCK(m_mutex, lock);
+    m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return job.done; });
+}
+
 void ChainstateManager::LoadExternalBlockFile(
     AutoFile& file_in,
     FlatFilePos* dbp,
@@ -5034,15 +5161,185 @@ void ChainstateManager::LoadExternalBlockFile(
     const auto start{SteadyClock::now()};
     const CChainParams& params{GetParams()};
 
+    // Blocks are imported in three stages: this thread finds them in the file
+    // and parses their headers, m_block_loader deserializes and checks those
+    // that are to be accepted, and this thread accepts them in file order,
+    // once enough blocks following them are being loaded.
+    struct FileBlock {
+        //! Position of the block in the file
+        uint64_t pos;
+        CBlockHeader header{};
+        uint256 hash{};
+        //! Loads the block, if it was to be accepted when it was found
+        std::shared_ptr<BlockLoader::Job> job{};
+    };
+    std::deque<FileBlock> blocks_ahead;
+    const size_t max_blocks_ahead{m_block_loader.HasThreads() ? MAX_BLOCKS_LOADED_AHEAD : 1};
+    SteadyClock::duration time_wait{0};
+    SteadyClock::duration time_accept{0};
+
     int nLoaded = 0;
+
+    // Whether a block found in the file is to be accepted, judging from the
+    // blocks known so far and those found before it.
+    const auto to_accept{[&](const FileBlock& item) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+        const CBlockIndex* pindex{m_blockman.LookupBlockIndex(item.hash)};
+        if (pindex && (pindex->nStatus & BLOCK_HAVE_DATA)) return false;
+        if (item.hash == params.GetConsensus().hashGenesisBlock || m_blockman.LookupBlockIndex(item.header.hashPrevBlock)) return true;
+        return std::any_of(blocks_ahead.begin(), blocks_ahead.end(), [&](const FileBlock& prev) { return prev.hash == item.header.hashPrevBlock; });
+    }};
+
+    // Accept a block found in the file, and those found before it that were
+    // waiting for it. Return false if the import has to stop.
+    const auto accept{[&](const FileBlock& item) {
+        const uint256& hash{item.hash};
+        const CBlockHeader& header{item.header};
+        if (dbp) dbp->nPos = item.pos;
+        if (item.job) {
+            const auto time_start{SteadyClock::now()};
+            m_block_loader.Wait(*item.job);
+            time_wait += SteadyClock::now() - time_start;
+        }
+
+        std::shared_ptr<const CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
+
+        {
+            LOCK(cs_main);
+            // detect out of order blocks, and store them for later
+            if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(header.hashPrevBlock)) {
+                LogDebug(BCLog::REINDEX, "LoadExternalBlockFile: Out of order block %s, parent %s not known\n", hash.ToString(),
+                         header.hashPrevBlock.ToString());
+                if (dbp && blocks_with_unknown_parent) {
+                    blocks_with_unknown_parent->emplace(header.hashPrevBlock, *dbp);
+                }
+                return true;
+            }
+
+            // process in case the block isn't known yet
+            const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
+            if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
+                if (item.job) {
+                    pblock = item.job->block;
+                } else if (dbp) {
+                    // The parent of the block was not known yet when it was found.
+                    auto block{std::make_shared<CBlock>()};
+                    if (m_blockman.ReadBlockFromDisk(*block, *dbp)) pblock = std::move(block);
+                }
+                if (!pblock) {
+                    // historical bugs added extra data to the block files that does not deserialize cleanly.
+                    // commonly this data is between readable blocks, but it does not really matter. such data is not fatal to the import process.
+                    // the code that reads the block files deals with invalid data by simply ignoring it.
+                    // it continues to search for the next {4 byte magic message start bytes + 4 byte length + block} that does deserialize cleanly
+                    // and passes all of the other block validation checks dealing with POW and the merkle root, etc...
+                    // we merely note with this informational log message when unexpected data is encountered.
+                    // we could also be experiencing a storage system read error, or a read of a previous bad write. these are possible, but
+                    // less likely scenarios. we don't have enough information to tell a difference here.
+                    // the reindex process is not the place to attempt to clean and/or compact the block files. if so desired, a studious node operator
+                    // may use knowledge of the fact that the block files are not entirely pristine in order to prepare a set of pristine, and
+                    // perhaps ordered, block files for later reindexing.
+                    LogDebug(BCLog::REINDEX, "LoadExternalBlockFile: unexpected data at file offset 0x%x - %s. continuing\n", item.pos,
+                             item.job ? item.job->error : "block not readable");
+                    return true;
+                }
+
+                const auto time_start{SteadyClock::now()};
+                BlockValidationState state;
+                if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
+                    nLoaded++;
+                }
+                time_accept += SteadyClock::now() - time_start;
+                if (state.IsError()) {
+                    return false;
+                }
+            } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+                LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
+            }
+        }
+
+        // Activate the genesis block so normal node progress can continue
+        if (hash == params.GetConsensus().hashGenesisBlock) {
+            for (auto c : GetAll()) {
+                BlockValidationState state;
+                if (!c->ActivateBestChain(state, nullptr)) {
+                    return false;
+                }
+            }
+        }
+
+        if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
+            // must update the tip for pruning to work while importing with -loadblock.
+            // this is a tradeoff to conserve disk space at the expense of time
+            // spent updating the tip to be able to prune.
+            // otherwise, ActivateBestChain won't be called by the import process
+            // until after all of the block files are loaded. ActivateBestChain can be
+            // called by concurrent network message processing. but, that is not
+            // reliable for the purpose of pruning while importing.
+            for (auto c : GetAll()) {
+                BlockValidationState state;
+                if (!c->ActivateBestChain(state, pblock)) {
+                    LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
+                    return false;
+                }
+            }
+        }
+
+        NotifyHeaderTip();
+
+        if (!blocks_with_unknown_parent) return true;
+
+        // Recursively process earlier encountered successors of this block,
+        // loading the successors of each block at once.
+        std::deque<uint256> queue;
+        queue.push_back(hash);
+        while (!queue.empty()) {
+            uint256 head = queue.front();
+            queue.pop_front();
+            auto range = blocks_with_unknown_parent->equal_range(head);
+            std::vector<std::pair<FlatFilePos, std::shared_ptr<BlockLoader::Job>>> children;
+            for (auto it = range.first; it != range.second; ++it) {
+                children.emplace_back(it->second, m_block_loader.Add([this, pos = it->second](CBlock& block) {
+                    return m_blockman.ReadBlockFromDisk(block, pos);
+                }));
+            }
+            blocks_with_unknown_parent->erase(range.first, range.second);
+            for (auto& [pos, job] : children) {
+                m_block_loader.Wait(*job);
+                if (job->block) {
+                    LogDebug(BCLog::REINDEX, "LoadExternalBlockFile: Processing out of order child %s of %s\n", job->block->GetHash().ToString(),
+                            head.ToString());
+                    LOCK(cs_main);
+                    BlockValidationState dummy;
+                    if (AcceptBlock(job->block, dummy, nullptr, true, &pos, nullptr, true)) {
+                        nLoaded++;
+                        queue.push_back(job->block->GetHash());
+                    }
+                }
+                NotifyHeaderTip();
+            }
+        }
+        return true;
+    }};
+
     try {
         BufferedFile blkdat{file_in, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
         // nRewind indicates where to resume scanning in case something goes wrong,
         // such as a block fails to deserialize.
         uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
+        bool end_of_file{false};
+        while (!end_of_file || !blocks_ahead.empty()) {
             if (m_interrupt) return;
 
+            if (end_of_file || blocks_ahead.size() >= max_blocks_ahead) {
+                const FileBlock item{std::move(blocks_ahead.front())};
+                blocks_ahead.pop_front();
+                if (!accept(item)) break;
+                continue;
+            }
+            if (blkdat.eof()) {
+                end_of_file = true;
+                continue;
+            }
+
             blkdat.SetPos(nRewind);
             nRewind++; // start one byte further next time, in case of failure
             blkdat.SetLimit(); // remove former limit
@@ -5063,135 +5360,35 @@ void ChainstateManager::LoadExternalBlockFile(
             } catch (const std::exception&) {
                 // no valid block header found; don't complain
                 // (this happens at the end of every blk.dat file)
-                break;
+                end_of_file = true;
+                continue;
             }
             try {
                 // read block header
                 const uint64_t nBlockPos{blkdat.GetPos()};
-                if (dbp)
-                    dbp->nPos = nBlockPos;
                 blkdat.SetLimit(nBlockPos + nSize);
-                CBlockHeader header;
-                blkdat >> header;
-                const uint256 hash{header.GetHash()};
-                // Skip the rest of this block (this may read from disk into memory); position to the marker before the
-                // next block, but it's still possible to rewind to the start of the current block (without a disk read).
+                FileBlock item{.pos = nBlockPos};
+                blkdat >> item.header;
+                item.hash = item.header.GetHash();
                 nRewind = nBlockPos + nSize;
-                blkdat.SkipTo(nRewind);
-
-                std::shared_ptr<CBlock> pblock{}; // needs to remain available after the cs_main lock is released to avoid duplicate reads from disk
-
-                {
-                    LOCK(cs_main);
-                    // detect out of order blocks, and store them for later
-                    if (hash != params.GetConsensus().hashGenesisBlock && !m_blockman.LookupBlockIndex(header.hashPrevBlock)) {
-                        LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                                 header.hashPrevBlock.ToString());
-                        if (dbp && blocks_with_unknown_parent) {
-                            blocks_with_unknown_parent->emplace(header.hashPrevBlock, *dbp);
-                        }
-                        continue;
-                    }
-
-                    // process in case the block isn't known yet
-                    const CBlockIndex* pindex = m_blockman.LookupBlockIndex(hash);
-                    if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
-                        // This block can be processed immediately; rewind to its start, read and deserialize it.
-                        blkdat.SetPos(nBlockPos);
-                        pblock = std::make_shared<CBlock>();
-                        blkdat >> TX_WITH_WITNESS(*pblock);
-                        nRewind = blkdat.GetPos();
-
-                        BlockValidationState state;
-                        if (AcceptBlock(pblock, state, nullptr, true, dbp, nullptr, true)) {
-                            nLoaded++;
-                        }
-                        if (state.IsError()) {
-                            break;
-                        }
-                    } else if (hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
-                        LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", hash.ToString(), pindex->nHeight);
-                    }
-                }
-
-                // Activate the genesis block so normal node progress can continue
-                if (hash == params.GetConsensus().hashGenesisBlock) {
-                    bool genesis_activation_failure = false;
-                    for (auto c : GetAll()) {
-                        BlockValidationState state;
-                        if (!c->ActivateBestChain(state, nullptr)) {
-                            genesis_activation_failure = true;
-                            break;
-                        }
-                    }
-                    if (genesis_activation_failure) {
-                        break;
-                    }
-                }
-
-                if (m_blockman.IsPruneMode() && m_blockman.m_blockfiles_indexed && pblock) {
-                    // must update the tip for pruning to work while importing with -loadblock.
-                    // this is a tradeoff to conserve disk space at the expense of time
-                    // spent updating the tip to be able to prune.
-                    // otherwise, ActivateBestChain won't be called by the import process
-                    // until after all of the block files are loaded. ActivateBestChain can be
-                    // called by concurrent network message processing. but, that is not
-                    // reliable for the purpose of pruning while importing.
-                    bool activation_failure = false;
-                    for (auto c : GetAll()) {
-                        BlockValidationState state;
-                        if (!c->ActivateBestChain(state, pblock)) {
-                            LogDebug(BCLog::REINDEX, "failed to activate chain (%s)\n", state.ToString());
-                            activation_failure = true;
-                            break;
-                        }
-                    }
-                    if (activation_failure) {
-                        break;
-                    }
-                }
-
-                NotifyHeaderTip();
-
-                if (!blocks_with_unknown_parent) continue;
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    auto range = blocks_with_unknown_parent->equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, FlatFilePos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (m_blockman.ReadBlockFromDisk(*pblockrecursive, it->second)) {
-                            LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
-                                    head.ToString());
-                            LOCK(cs_main);
-                            BlockValidationState dummy;
-                            if (AcceptBlock(pblockrecursive, dummy, nullptr, true, &it->second, nullptr, true)) {
-                                nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
-                            }
-                        }
-                        range.first++;
-                        blocks_with_unknown_parent->erase(it);
-                        NotifyHeaderTip();
-                    }
+                // Blocks imported with -loadblock are loaded even if they are
+                // not to be accepted yet, as they cannot be read again later.
+                if (!dbp || WITH_LOCK(cs_main, return to_accept(item))) {
+                    // Copy the block out of the buffer, to be deserialized by m_block_loader.
+                    std::vector<unsigned char> data(nSize);
+                    blkdat.SetPos(nBlockPos);
+                    blkdat.read(MakeWritableByteSpan(data));
+                    item.job = m_block_loader.Add([data = std::move(data)](CBlock& block) {
+                        SpanReader{data} >> TX_WITH_WITNESS(block);
+                        return true;
+                    });
+                } else {
+                    // Skip the rest of this block (this may read from disk into memory); position to the marker before the
+                    // next block, but it's still possible to rewind to the start of the current block (without a disk read).
+                    blkdat.SkipTo(nRewind);
                 }
+                blocks_ahead.push_back(std::move(item));
             } catch (const std::exception& e) {
-                // historical bugs added extra data to the block files that does not deserialize cleanly.
-                // commonly this data is between readable blocks, but it does not really matter. such data is not fatal to the import process.
-                // the code that reads the block files deals with invalid data by simply ignoring it.
-                // it continues to search for the next {4 byte magic message start bytes + 4 byte length + block} that does deserialize cleanly
-                // and passes all of the other block validation checks dealing with POW and the merkle root, etc...
-                // we merely note with this informational log message when unexpected data is encountered.
-                // we could also be experiencing a storage system read error, or a read of a previous bad write. these are possible, but
-                // less likely scenarios. we don't have enough information to tell a difference here.
-                // the reindex process is not the place to attempt to clean and/or compact the block files. if so desired, a studious node operator
-                // may use knowledge of the fact that the block files are not entirely pristine in order to prepare a set of pristine, and
-                // perhaps ordered, block files for later reindexing.
                 LogDebug(BCLog::REINDEX, "%s: unexpected data at file offset 0x%x - %s. continuing\n", __func__, (nRewind - 1), e.what());
             }
         }
@@ -5199,6 +5396,8 @@ void ChainstateManager::LoadExternalBlockFile(
         GetNotifications().fatalError(strprintf(_("System error while loading external block file: %s"), e.what()));
     }
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    LogDebug(BCLog::BENCH, "  - Waiting for blocks to load: %.2fms, accepting blocks: %.2fms\n",
+             Ticks<MillisecondsDouble>(time_wait), Ticks<MillisecondsDouble>(time_accept));
 }
 
 bool ChainstateManager::ShouldCheckBlockIndex() const
@@ -5872,41 +6071,22 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     }
 
     const uint64_t coins_count = metadata.m_coins_count;
-    uint64_t coins_left = metadata.m_coins_count;
 
-    LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
+    LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_count, base_blockhash.ToString());
     int64_t coins_processed{0};
 
-    while (coins_left > 0) {
-        try {
-            Txid txid;
-            coins_file >> txid;
-            size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
-
-            if (coins_per_txid > coins_left) {
-                return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+    // The coins are read and hashed by another thread while this one adds them
+    // to the coins cache and flushes it.
+    std::optional<uint256> hash_serialized;
+    {
+        node::SnapshotCoinsReader reader{coins_file, coins_count, base_height};
+        while (auto batch{reader.Next()}) {
+            if (batch->error) {
+                return util::Error{Untranslated(*batch->error)};
             }
-
-            for (size_t i = 0; i < coins_per_txid; i++) {
-                COutPoint outpoint;
-                Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
-                outpoint.hash = txid;
-                coins_file >> coin;
-                if (coin.nHeight > base_height ||
-                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-                ) {
-                    return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins"),
-                              coins_count - coins_left)};
-                }
-                if (!MoneyRange(coin.out.nValue)) {
-                    return util::Error{strprintf(Untranslated("Bad snapshot data after deserializing %d coins - bad tx out value"),
-                              coins_count - coins_left)};
-                }
+            for (auto& [outpoint, coin] : batch->coins) {
                 coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
 
-                --coins_left;
                 ++coins_processed;
 
                 if (coins_processed % 1000000 == 0) {
@@ -5939,10 +6119,8 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
                     }
                 }
             }
-        } catch (const std::ios_base::failure&) {
-            return util::Error{strprintf(Untranslated("Bad snapshot format or truncated snapshot after deserializing %d coins"),
-                      coins_processed)};
         }
+        hash_serialized = reader.GetHash();
     }
 
     // Important that we set this. This and the coins_cache accesses above are
@@ -5952,19 +6130,6 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     // method.
     coins_cache.SetBestBlock(base_blockhash);
 
-    bool out_of_coins{false};
-    try {
-        std::byte left_over_byte;
-        coins_file >> left_over_byte;
-    } catch (const std::ios_base::failure&) {
-        // We expect an exception since we should be out of coins.
-        out_of_coins = true;
-    }
-    if (!out_of_coins) {
-        return util::Error{strprintf(Untranslated("Bad snapshot - coins left over after deserializing %d coins"),
-            coins_count)};
-    }
-
     LogPrintf("[snapshot] loaded %d (%.2f MB) coins from snapshot %s\n",
         coins_count,
         coins_cache.DynamicMemoryUsage() / (1000 * 1000),
@@ -5975,26 +6140,33 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
 
     assert(coins_cache.GetBestBlock() == base_blockhash);
 
-    // As above, okay to immediately release cs_main here since no other context knows
-    // about the snapshot_chainstate.
-    CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
+    if (!hash_serialized) {
+        // The coins were not in database order, so their hash is computed
+        // from the database.
+        LogPrintf("[snapshot] coins not in database order, hashing the loaded coins\n");
 
-    std::optional<CCoinsStats> maybe_stats;
+        // As above, okay to immediately release cs_main here since no other context knows
+        // about the snapshot_chainstate.
+        CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+        std::optional<CCoinsStats> maybe_stats;
+
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{*hash_serialized} != au_data.hash_serialized) {
         return util::Error{strprintf(Untranslated("Bad snapshot content hash: expected %s, got %s"),
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString())};
+            au_data.hash_serialized.ToString(), hash_serialized->ToString())};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -6256,6 +6428,7 @@ ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Opt
       m_interrupt{interrupt},
       m_options{Flatten(std::move(options))},
       m_blockman{interrupt, std::move(blockman_options)},
+      m_block_loader{m_options.chainparams.GetConsensus(), m_options.block_load_threads},
       m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes}
 {
 }
@@ -35,6 +35,9 @@
 #include <versionbits.h>
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -42,6 +45,7 @@
 #include <span>
 #include <stdint.h>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -486,6 +490,59 @@ public:
     void InitCache() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 
+/** Maximum number of blocks loaded ahead of their validation by a BlockLoader */
+static constexpr size_t MAX_BLOCKS_LOADED_AHEAD{32};
+
+/**
+ * Threads loading blocks, i.e. reading them from disk or deserializing them,
+ * and checking them with CheckBlock() ahead of their validation, so that the
+ * thread validating many blocks in a row does not wait for each of them. This
+ * is used during -reindex, -reindex-chainstate, and when connecting blocks
+ * that were downloaded ahead of the tip.
+ *
+ * Without threads, blocks are loaded by the thread waiting for them.
+ */
+class BlockLoader
+{
+public:
+    /** A block to be loaded. */
+    struct Job {
+        //! Read or deserialize the block, returning false or throwing if that fails
+        const std::function<bool(CBlock&)> load;
+        //! The loaded block, or nullptr if loading it failed
+        std::shared_ptr<const CBlock> block;
+        //! Why loading the block failed, if it threw
+        std::string error;
+        //! Set once the fields above are final, guarded by BlockLoader::m_mutex
+        bool done{false};
+
+        explicit Job(std::function<bool(CBlock&)> load) : load{std::move(load)} {}
+    };
+
+    BlockLoader(const Consensus::Params& consensus, int threads);
+    ~BlockLoader();
+
+    bool HasThreads() const { return !m_threads.empty(); }
+
+    //! Queue a block to be loaded by the threads.
+    std::shared_ptr<Job> Add(std::function<bool(CBlock&)> load) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Wait until a block is loaded, or load it if there are no threads.
+    void Wait(Job& job) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const Consensus::Params& m_consensus;
+    Mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    std::deque<std::shared_ptr<Job>> m_queue GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_threads;
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Load(Job& job) const;
+};
+
 enum class CoinsCacheSizeState
 {
     //! The coins cache is in immediate need of a flush.
@@ -775,6 +832,13 @@ public:
     }
 
 private:
+    //! Blocks of the chain being connected, loaded ahead by the BlockLoader of m_chainman
+    std::map<const CBlockIndex*, std::shared_ptr<BlockLoader::Job>> m_blocks_loaded_ahead GUARDED_BY(::cs_main);
+
+    //! Start loading the blocks following the tip towards pindex_most_work,
+    //! other than pblock, ahead of their connection.
+    void LoadBlocksAhead(const CBlockIndex& pindex_most_work, const CBlock* pblock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     bool ActivateBestChainStep(BlockValidationState& state, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
     bool ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
 
@@ -1011,6 +1075,10 @@ public:
     //! chainstate to avoid duplicating block metadata.
     node::BlockManager m_blockman;
 
+    //! Loads blocks ahead of their validation. Declared after m_blockman, as
+    //! its threads may read blocks through it.
+    BlockLoader m_block_loader;
+
     ValidationCache m_validation_cache;
 
     /**
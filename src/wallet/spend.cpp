@@ -742,20 +742,25 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
     }
 
     // If the chosen input set has unconfirmed inputs, check for synergies from overlapping ancestry
-    for (auto& result : results) {
-        std::vector<COutPoint> outpoints;
-        std::set<std::shared_ptr<COutput>> coins = result.GetInputSet();
-        CAmount summed_bump_fees = 0;
-        for (auto& coin : coins) {
+    std::vector<std::vector<COutPoint>> outpoint_sets;
+    std::vector<CAmount> summed_bump_fees;
+    for (const auto& result : results) {
+        std::vector<COutPoint>& outpoints{outpoint_sets.emplace_back()};
+        CAmount& summed{summed_bump_fees.emplace_back(0)};
+        for (auto& coin : result.GetInputSet()) {
             if (coin->depth > 0) continue; // Bump fees only exist for unconfirmed inputs
             outpoints.push_back(coin->outpoint);
-            summed_bump_fees += coin->ancestor_bump_fees;
+            summed += coin->ancestor_bump_fees;
         }
-        std::optional<CAmount> combined_bump_fee = chain.calculateCombinedBumpFee(outpoints, coin_selection_params.m_effective_feerate);
+    }
+    const std::vector<std::optional<CAmount>> combined_bump_fees{chain.calculateCombinedBumpFees(outpoint_sets, coin_selection_params.m_effective_feerate)};
+    for (size_t i = 0; i < results.size(); ++i) {
+        SelectionResult& result{results[i]};
+        const std::optional<CAmount>& combined_bump_fee{combined_bump_fees[i]};
         if (!combined_bump_fee.has_value()) {
             return util::Error{_("Failed to calculate bump fees, because unconfirmed UTXOs depend on enormous cluster of unconfirmed transactions.")};
         }
-        CAmount bump_fee_overestimate = summed_bump_fees - combined_bump_fee.value();
+        CAmount bump_fee_overestimate = summed_bump_fees[i] - combined_bump_fee.value();
         if (bump_fee_overestimate) {
             result.SetBumpFeeDiscount(bump_fee_overestimate);
         }
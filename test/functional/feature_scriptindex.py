@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the script index through the getscripthistory RPC and the REST interface.
+
+Test that the history of a script includes the outputs funding it and the
+inputs spending from it, that it can be paged through, and that entries of
+disconnected blocks are removed.
+"""
+from decimal import Decimal
+import http.client
+import json
+import urllib.parse
+
+from test_framework.messages import COIN
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+
+class ScriptIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [["-scriptindex", "-rest"]]
+
+    def rest_history(self, script_hex, status=200, **query_params):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        uri = f"/rest/scripthistory/{script_hex}.json"
+        if query_params:
+            uri += f"?{urllib.parse.urlencode(query_params)}"
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("GET", uri)
+        resp = conn.getresponse()
+        assert_equal(resp.status, status)
+        body = resp.read().decode("utf-8")
+        return json.loads(body, parse_float=Decimal) if status == 200 else body
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        target = MiniWallet(node, tag_name="scriptindex")
+        script_hex = target.get_scriptPubKey().hex()
+        self.wait_until(lambda: node.getindexinfo("scriptindex")["scriptindex"]["synced"])
+
+        self.log.info("Test that a script without history has no entries")
+        assert_equal(node.getscripthistory(script_hex), {"history": []})
+
+        self.log.info("Test that outputs funding the script are returned in chain order")
+        fundings = []
+        for amount in [1, 2, 3]:
+            res = wallet.send_to(from_node=node, scriptPubKey=target.get_scriptPubKey(), amount=amount * COIN)
+            target.scan_tx(node.decoderawtransaction(res["hex"]))
+            block_hash = self.generate(node, 1)[0]
+            fundings.append({
+                "type": "funding",
+                "height": node.getblockcount(),
+                "blockhash": block_hash,
+                "txid": res["txid"],
+                "vout": res["sent_vout"],
+                "amount": Decimal(amount),
+            })
+        assert_equal(node.getscripthistory(script_hex)["history"], fundings)
+
+        self.log.info("Test that inputs spending from the script are returned")
+        spent_utxo = target.get_utxo(txid=fundings[0]["txid"])
+        spend = target.send_self_transfer(from_node=node, utxo_to_spend=spent_utxo)
+        spend_block = self.generate(node, 1)[0]
+        height = node.getblockcount()
+        history = node.getscripthistory(script_hex)["history"]
+        assert_equal(len(history), 5)
+        assert_equal(history[:3], fundings)
+        # Within a transaction, outputs sort before inputs
+        assert_equal(history[3], {
+            "type": "funding",
+            "height": height,
+            "blockhash": spend_block,
+            "txid": spend["txid"],
+            "vout": 0,
+            "amount": spend["tx"].vout[0].nValue / Decimal(COIN),
+        })
+        assert_equal(history[4], {
+            "type": "spending",
+            "height": height,
+            "blockhash": spend_block,
+            "txid": spend["txid"],
+            "vin": 0,
+            "prevout": {"txid": fundings[0]["txid"], "vout": fundings[0]["vout"]},
+            "amount": Decimal(1),
+        })
+
+        self.log.info("Test paging through the history")
+        paged = []
+        after = None
+        while True:
+            page = node.getscripthistory(script_hex, 2, after) if after else node.getscripthistory(script_hex, 2)
+            assert len(page["history"]) <= 2
+            paged += page["history"]
+            if "next" not in page:
+                break
+            after = page["next"]
+        assert_equal(paged, history)
+        assert_equal(node.getscripthistory(script_hex, 5), {"history": history})
+        assert "next" in node.getscripthistory(script_hex, 4)
+
+        self.log.info("Test the REST interface")
+        assert_equal(self.rest_history(script_hex), {"history": history})
+        first_page = self.rest_history(script_hex, count=3)
+        assert_equal(first_page["history"], history[:3])
+        assert_equal(self.rest_history(script_hex, after=first_page["next"]), {"history": history[3:]})
+        assert_equal(self.rest_history(script_hex, count=3), node.getscripthistory(script_hex, 3))
+        assert "must be an integer between 1 and 1000" in self.rest_history(script_hex, status=400, count=0)
+        assert "must be an integer between 1 and 1000" in self.rest_history(script_hex, status=400, count=1001)
+        assert "Invalid \"after\" cursor" in self.rest_history(script_hex, status=400, after="00")
+        assert "Invalid scriptPubKey" in self.rest_history("zz", status=400)
+
+        self.log.info("Test invalid parameters")
+        assert_raises_rpc_error(-8, "Invalid count, must be between 1 and 1000", node.getscripthistory, script_hex, 0)
+        assert_raises_rpc_error(-8, "Invalid count, must be between 1 and 1000", node.getscripthistory, script_hex, 1001)
+        assert_raises_rpc_error(-8, "Invalid after cursor", node.getscripthistory, script_hex, 10, "00")
+        assert_raises_rpc_error(-8, "scriptpubkey must be hexadecimal string", node.getscripthistory, "zz")
+
+        self.log.info("Test that entries of disconnected blocks are removed")
+        node.invalidateblock(spend_block)
+        self.generateblock(node, output=wallet.get_address(), transactions=[])
+        assert_equal(node.getscripthistory(script_hex)["history"], fundings)
+
+        self.log.info("Test that the index is persisted across restarts")
+        self.restart_node(0)
+        self.wait_until(lambda: node.getindexinfo("scriptindex")["scriptindex"]["synced"])
+        assert_equal(node.getscripthistory(script_hex)["history"], fundings)
+
+        self.log.info("Test that the RPC fails when the index is not enabled")
+        self.restart_node(0, extra_args=["-rest"])
+        assert_equal(node.getindexinfo("scriptindex"), {})
+        assert_raises_rpc_error(-1, "Script index is not enabled, use -scriptindex", node.getscripthistory, script_hex)
+        assert "Script index is not enabled" in self.rest_history(script_hex, status=400)
+
+
+if __name__ == '__main__':
+    ScriptIndexTest(__file__).main()
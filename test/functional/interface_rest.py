@@ -385,6 +385,22 @@ class RESTTest (BitcoinTestFramework):
         resp = self.test_rest_request("/mempool/contents", ret_type=RetType.OBJ, status=400, query_params={"verbose": "false", "mempool_sequence": "TRUE"})
         assert_equal(resp.read().decode('utf-8').strip(), 'The "mempool_sequence" query parameter must be either "true" or "false".')
 
+        # Check the mempool fee histogram
+        json_obj = self.test_rest_request("/mempool/feehistogram")
+        assert_equal(json_obj, self.nodes[0].getmempoolfeehistogram())
+        assert_equal(json_obj['size'], 3)
+        assert_equal(sum(bucket['count'] for bucket in json_obj['fee_histogram']), 3)
+
+        # Check the mempool events since the first of the 3 transactions was added
+        sequence = raw_mempool['mempool_sequence'] - 3
+        json_obj = self.test_rest_request("/mempool/events", query_params={"sequence": sequence})
+        assert_equal(json_obj, self.nodes[0].getmempoolevents(sequence))
+        assert_equal(len(json_obj['events']), 3)
+        resp = self.test_rest_request("/mempool/events", ret_type=RetType.OBJ, status=404, query_params={"sequence": raw_mempool['mempool_sequence'] + 1})
+        assert_equal(resp.read().decode('utf-8').strip(), f"Mempool events since sequence {raw_mempool['mempool_sequence'] + 1} are not available")
+        resp = self.test_rest_request("/mempool/events", ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').strip(), 'The "sequence" query parameter must be a non-negative integer.')
+
         # Now mine the transactions
         newblockhash = self.generate(self.nodes[1], 1)
 
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test replaying mempool events through the getmempoolevents RPC."""
+from decimal import Decimal
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+EVENT_LOG_SIZE = 8
+
+
+class MempoolEventsTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [[f"-mempooleventlog={EVENT_LOG_SIZE}"]]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+
+        self.log.info("Test that no events are returned when up to date")
+        start = node.getrawmempool(verbose=False, mempool_sequence=True)['mempool_sequence']
+        assert_equal(node.getmempoolevents(start), {'mempool_sequence': start, 'events': []})
+
+        self.log.info("Test that additions are replayed in sequence")
+        tx_a = self.wallet.send_self_transfer(from_node=node)
+        tx_b = self.wallet.send_self_transfer(from_node=node)
+        res = node.getmempoolevents(start)
+        assert_equal(res['mempool_sequence'], start + 2)
+        assert_equal(res['events'], [
+            {'sequence': start, 'type': 'added', 'txid': tx_a['txid'], 'wtxid': tx_a['wtxid']},
+            {'sequence': start + 1, 'type': 'added', 'txid': tx_b['txid'], 'wtxid': tx_b['wtxid']},
+        ])
+        assert_equal(node.getmempoolevents(start + 1)['events'], res['events'][1:])
+
+        self.log.info("Test that removals for blocks and replacements are replayed")
+        self.generate(node, 1)
+        seq = start + 2
+        res = node.getmempoolevents(seq)
+        assert_equal(res['mempool_sequence'], seq + 2)
+        assert_equal(sorted(e['txid'] for e in res['events']), sorted([tx_a['txid'], tx_b['txid']]))
+        assert all(e['type'] == 'removed' and e['reason'] == 'block' for e in res['events'])
+        assert_equal([e['sequence'] for e in res['events']], [seq, seq + 1])
+
+        seq += 2
+        utxo = self.wallet.get_utxo()
+        original = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo, fee_rate=Decimal("0.0001"))
+        replacement = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo, fee_rate=Decimal("0.001"))
+        res = node.getmempoolevents(seq)
+        assert_equal(res['events'], [
+            {'sequence': seq, 'type': 'added', 'txid': original['txid'], 'wtxid': original['wtxid']},
+            {'sequence': seq + 1, 'type': 'removed', 'txid': original['txid'], 'wtxid': original['wtxid'], 'reason': 'replaced'},
+            {'sequence': seq + 2, 'type': 'added', 'txid': replacement['txid'], 'wtxid': replacement['wtxid']},
+        ])
+        seq += 3
+
+        self.log.info("Test that replaying events gives the same mempool as a full resync")
+        txids = set(node.getrawmempool())
+        replayed = set()
+        for event in node.getmempoolevents(start)['events']:
+            if event['type'] == 'added':
+                replayed.add(event['txid'])
+            else:
+                replayed.discard(event['txid'])
+        assert_equal(replayed, txids)
+
+        self.log.info("Test invalid sequences and sequences ahead of the mempool")
+        assert_raises_rpc_error(-8, "Invalid parameter, sequence must be non-negative", node.getmempoolevents, -1)
+        assert_raises_rpc_error(-1, f"Mempool events since sequence {seq + 1} are not available, resync with getrawmempool", node.getmempoolevents, seq + 1)
+
+        self.log.info("Test that clients older than the event log need to resync")
+        for _ in range(EVENT_LOG_SIZE):
+            self.wallet.send_self_transfer(from_node=node)
+        oldest = seq
+        res = node.getmempoolevents(oldest)
+        assert_equal(len(res['events']), EVENT_LOG_SIZE)
+        assert_equal(res['events'][0]['sequence'], oldest)
+        self.wallet.send_self_transfer(from_node=node)
+        assert_raises_rpc_error(-1, f"Mempool events since sequence {oldest} are not available, resync with getrawmempool", node.getmempoolevents, oldest)
+        assert_equal(len(node.getmempoolevents(oldest + 1)['events']), EVENT_LOG_SIZE)
+
+        self.log.info("Test that the event log can be disabled")
+        self.restart_node(0, extra_args=["-mempooleventlog=0", "-persistmempool=0"])
+        seq = node.getrawmempool(verbose=False, mempool_sequence=True)['mempool_sequence']
+        assert_equal(node.getmempoolevents(seq)['events'], [])
+        self.wallet.send_self_transfer(from_node=node)
+        assert_raises_rpc_error(-1, "are not available", node.getmempoolevents, seq)
+
+
+if __name__ == '__main__':
+    MempoolEventsTest(__file__).main()
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the getmempoolfeehistogram RPC."""
+from decimal import Decimal
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+
+class MempoolFeeHistogramTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def bucket_for(self, histogram, feerate):
+        for bucket in histogram['fee_histogram']:
+            if bucket['feerate_from'] <= feerate and ('feerate_to' not in bucket or feerate < bucket['feerate_to']):
+                return bucket
+        assert False
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+
+        self.log.info("Test an empty mempool")
+        histogram = node.getmempoolfeehistogram()
+        assert_equal(histogram['size'], 0)
+        assert_equal(histogram['bytes'], 0)
+        assert all(bucket['count'] == 0 for bucket in histogram['fee_histogram'])
+        assert all(p['feerate'] == 0 for p in histogram['percentiles'])
+        assert_equal([p['percentile'] for p in histogram['percentiles']], [5, 10, 25, 50, 75, 90, 95])
+
+        self.log.info("Test that transactions are counted at their ancestor feerate")
+        parent = self.wallet.send_self_transfer(from_node=node, fee_rate=Decimal("0.000035"))
+        child = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=parent['new_utxo'], fee_rate=Decimal("0.00055"))
+        unrelated = self.wallet.send_self_transfer(from_node=node, fee_rate=Decimal("0.00130"))
+
+        histogram = node.getmempoolfeehistogram()
+        assert_equal(histogram, node.getmempoolfeehistogram([5, 10, 25, 50, 75, 90, 95]))
+        mempool_info = node.getmempoolinfo()
+        assert_equal(histogram['size'], 3)
+        assert_equal(histogram['bytes'], mempool_info['bytes'])
+        assert_equal(histogram['total_fee'], mempool_info['total_fee'])
+        assert_equal(sum(bucket['vsize'] for bucket in histogram['fee_histogram']), mempool_info['bytes'])
+
+        assert_equal(self.bucket_for(histogram, 3.5)['vsize'], parent['tx'].get_vsize())
+        package_feerate = (parent['fee'] + child['fee']) * Decimal(1e8) / (parent['tx'].get_vsize() + child['tx'].get_vsize())
+        assert_equal(self.bucket_for(histogram, package_feerate)['vsize'], child['tx'].get_vsize())
+        assert_equal(self.bucket_for(histogram, 130)['vsize'], unrelated['tx'].get_vsize())
+
+        self.log.info("Test percentiles")
+        histogram = node.getmempoolfeehistogram([0, 100])
+        assert_equal(histogram['percentiles'], [{'percentile': 0, 'feerate': 3}, {'percentile': 100, 'feerate': 120}])
+
+        self.log.info("Test prioritisetransaction moves transactions between buckets")
+        node.prioritisetransaction(txid=parent['txid'], fee_delta=150 * parent['tx'].get_vsize())
+        histogram = node.getmempoolfeehistogram()
+        assert_equal(self.bucket_for(histogram, 153.5)['vsize'], parent['tx'].get_vsize())
+        assert_equal(self.bucket_for(histogram, 55)['vsize'], child['tx'].get_vsize())
+
+        self.log.info("Test invalid percentiles")
+        assert_raises_rpc_error(-8, "Invalid parameter, percentiles must be between 0 and 100", node.getmempoolfeehistogram, [101])
+        assert_raises_rpc_error(-8, "Invalid parameter, percentiles must be between 0 and 100", node.getmempoolfeehistogram, [-1])
+
+        self.log.info("Test the histogram is emptied when the transactions are mined")
+        self.generate(node, 1)
+        histogram = node.getmempoolfeehistogram()
+        assert_equal(histogram['size'], 0)
+        assert all(bucket['count'] == 0 for bucket in histogram['fee_histogram'])
+
+
+if __name__ == '__main__':
+    MempoolFeeHistogramTest(__file__).main()
@@ -80,6 +80,7 @@ class BlockchainTest(BitcoinTestFramework):
                 "-stopatheight=207",
                 "-checkblocks=-1",  # Check all blocks
                 "-prune=1",  # Set pruning after rescan is complete
+                "-dbcompactionrate=100",
             ],
         )
 
@@ -88,6 +89,7 @@ class BlockchainTest(BitcoinTestFramework):
         self._test_gettxoutsetinfo()
         self._test_getblockheader()
         self._test_getdifficulty()
+        self._test_getcompactionstats()
         self._test_getnetworkhashps()
         self._test_stopatheight()
         self._test_waitforblockheight()
@@ -437,6 +439,18 @@ class BlockchainTest(BitcoinTestFramework):
         # binary => decimal => binary math is why we do this check
         assert abs(difficulty * 2**31 - 1) < 0.0001
 
+    def _test_getcompactionstats(self):
+        self.log.info("Test getcompactionstats")
+        stats = self.nodes[0].getcompactionstats()
+        assert_equal(sorted(stats.keys()), ["blockindex", "chainstate"])
+        for db_stats in stats.values():
+            assert_equal(sorted(db_stats.keys()), ["levels", "pending_bytes", "stall_time"])
+            assert_equal(len(db_stats["levels"]), 7)
+            for level in db_stats["levels"]:
+                assert_equal(sorted(level.keys()), ["bytes", "bytes_read", "bytes_written", "compaction_time", "files"])
+            assert_equal(db_stats["pending_bytes"], 0)
+            assert_equal(db_stats["stall_time"], 0)
+
     def _test_getnetworkhashps(self):
         self.log.info("Test getnetworkhashps")
         assert_raises_rpc_error(
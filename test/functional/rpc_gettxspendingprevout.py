@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test looking up confirmed spends with gettxspendingprevout and -txospenderindex."""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+
+class GetTxSpendingPrevoutTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [["-txospenderindex"], []]
+
+    def wait_for_index(self, node):
+        self.wait_until(lambda: node.getindexinfo("txospenderindex")["txospenderindex"]["synced"])
+
+    def run_test(self):
+        node, node_noindex = self.nodes
+        wallet = MiniWallet(node)
+        self.wait_for_index(node)
+
+        self.log.info("Test that confirmed spends are found with -txospenderindex")
+        utxo = wallet.get_utxo()
+        spend = wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo)
+        block_hash = self.generate(node, 1)[0]
+        prevout = {"txid": utxo["txid"], "vout": utxo["vout"]}
+        new_output = {"txid": spend["txid"], "vout": 0}
+        confirmed = {**prevout, "spendingtxid": spend["txid"], "blockhash": block_hash}
+        assert_equal(node.gettxspendingprevout([prevout, new_output]), [confirmed, new_output])
+        assert_equal(node.gettxspendingprevout([prevout], mempool_only=False), [confirmed])
+        assert_equal(node.gettxspendingprevout([prevout], mempool_only=True), [prevout])
+
+        self.log.info("Test that mempool spends are found first")
+        child = wallet.send_self_transfer(from_node=node, utxo_to_spend=spend["new_utxo"])
+        self.sync_mempools()
+        assert_equal(node.gettxspendingprevout([new_output, prevout]), [{**new_output, "spendingtxid": child["txid"]}, confirmed])
+
+        self.log.info("Test that without the index only the mempool is searched")
+        assert_equal(node_noindex.gettxspendingprevout([prevout, new_output]), [prevout, {**new_output, "spendingtxid": child["txid"]}])
+        assert_equal(node_noindex.gettxspendingprevout([new_output], mempool_only=False), [{**new_output, "spendingtxid": child["txid"]}])
+        assert_raises_rpc_error(-1, "Mempool lacks a relevant spend, and -txospenderindex is not enabled",
+                                node_noindex.gettxspendingprevout, [prevout], mempool_only=False)
+
+        self.log.info("Test that spends of disconnected blocks are removed")
+        self.generate(node, 1)
+        self.disconnect_nodes(0, 1)
+        node.invalidateblock(block_hash)
+        self.generateblock(node, output=wallet.get_address(), transactions=[], sync_fun=self.no_op)
+        # The spend is back in the mempool, and no longer reported as confirmed
+        assert_equal(node.gettxspendingprevout([prevout]), [{**prevout, "spendingtxid": spend["txid"]}])
+        # Mine two blocks so that the other node reorgs to this chain
+        new_block_hash = self.generate(node, 2, sync_fun=self.no_op)[0]
+        assert_equal(node.gettxspendingprevout([prevout]), [{**confirmed, "blockhash": new_block_hash}])
+        self.connect_nodes(0, 1)
+        self.sync_blocks()
+
+        self.log.info("Test building the index from scratch")
+        self.restart_node(1, extra_args=["-txospenderindex"])
+        self.wait_for_index(node_noindex)
+        assert_equal(node_noindex.gettxspendingprevout([prevout]), node.gettxspendingprevout([prevout]))
+        assert_equal(node_noindex.gettxspendingprevout([new_output])[0]["spendingtxid"], child["txid"])
+
+        self.log.info("Test that the index is persisted across restarts")
+        self.restart_node(0)
+        self.wait_for_index(node)
+        assert_equal(node.gettxspendingprevout([prevout]), [{**confirmed, "blockhash": new_block_hash}])
+
+
+if __name__ == '__main__':
+    GetTxSpendingPrevoutTest(__file__).main()
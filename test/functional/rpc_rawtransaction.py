@@ -85,6 +85,7 @@ class RawTransactionsTest(BitcoinTestFramework):
         self.wallet = MiniWallet(self.nodes[0])
 
         self.getrawtransaction_tests()
+        self.getrawtransactions_tests()
         self.createrawtransaction_tests()
         self.sendrawtransaction_tests()
         self.sendrawtransaction_testmempoolaccept_tests()
@@ -181,6 +182,30 @@ class RawTransactionsTest(BitcoinTestFramework):
         block = self.nodes[0].getblock(self.nodes[0].getblockhash(0))
         assert_raises_rpc_error(-5, "The genesis block coinbase is not considered an ordinary transaction", self.nodes[0].getrawtransaction, block['merkleroot'])
 
+    def getrawtransactions_tests(self):
+        self.log.info("Test getrawtransactions")
+        confirmed = [self.wallet.send_self_transfer(from_node=self.nodes[0]) for _ in range(3)]
+        self.generate(self.nodes[0], 1)
+        unconfirmed = self.wallet.send_self_transfer(from_node=self.nodes[0])
+        self.sync_mempools()
+        unknown = "00" * 32
+        txs = [confirmed[2], unconfirmed, confirmed[0], confirmed[1]]
+        txids = [tx['txid'] for tx in txs]
+
+        self.log.info("Test getrawtransactions with -txindex")
+        assert_equal(self.nodes[0].getrawtransactions([unknown] + txids), [None] + [tx['hex'] for tx in txs])
+        assert_equal(self.nodes[0].getrawtransactions([]), [])
+        gottxs = self.nodes[0].getrawtransactions(txids, True)
+        for gottx, txid in zip(gottxs, txids):
+            assert_equal(gottx, self.nodes[0].getrawtransaction(txid, 1))
+
+        self.log.info("Test getrawtransactions without -txindex only returns mempool transactions")
+        assert_equal(self.nodes[2].getrawtransactions(txids), [None, unconfirmed['hex'], None, None])
+
+        assert_raises_rpc_error(-8, "txid must be of length 64", self.nodes[0].getrawtransactions, ["abcd"])
+        assert_raises_rpc_error(-3, "not of expected type array", self.nodes[0].getrawtransactions, txids[0])
+        self.generate(self.nodes[0], 1)
+
     def getrawtransaction_verbosity_tests(self):
         tx = self.wallet.send_self_transfer(from_node=self.nodes[1])['txid']
         [block1] = self.generate(self.nodes[1], 1)